@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using BenchClock = std::chrono::steady_clock;
+
+inline double ElapsedMs(BenchClock::time_point start, BenchClock::time_point end = BenchClock::now()) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// "--name value" and "--flag" options. Unknown options are reported so a
+// typo never silently runs the default configuration.
+class BenchArgs {
+public:
+    BenchArgs(int argc, char** argv) : args(argv + 1, argv + argc), used(args.size(), false) {}
+
+    bool Flag(const char* name) {
+        for (size_t i = 0; i < args.size(); ++i) {
+            if (args[i] == name) {
+                used[i] = true;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string Text(const char* name, const std::string& fallback) {
+        for (size_t i = 0; i + 1 < args.size(); ++i) {
+            if (args[i] == name) {
+                used[i] = used[i + 1] = true;
+                return args[i + 1];
+            }
+        }
+        return fallback;
+    }
+
+    std::vector<std::string> List(const char* name) {
+        std::vector<std::string> values;
+        for (size_t i = 0; i + 1 < args.size(); ++i) {
+            if (args[i] == name) {
+                used[i] = used[i + 1] = true;
+                values.push_back(args[i + 1]);
+            }
+        }
+        return values;
+    }
+
+    size_t Size(const char* name, size_t fallback) {
+        std::string text = Text(name, "");
+        return text.empty() ? fallback : (size_t)std::strtoull(text.c_str(), nullptr, 10);
+    }
+
+    double Number(const char* name, double fallback) {
+        std::string text = Text(name, "");
+        return text.empty() ? fallback : std::strtod(text.c_str(), nullptr);
+    }
+
+    bool CheckAllUsed() const {
+        bool ok = true;
+        for (size_t i = 0; i < args.size(); ++i) {
+            if (!used[i]) {
+                std::fprintf(stderr, "unknown argument: %s\n", args[i].c_str());
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+private:
+    std::vector<std::string> args;
+    std::vector<bool> used;
+};
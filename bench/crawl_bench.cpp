@@ -0,0 +1,166 @@
+// Crawls a generated folder tree with the launcher's CrawlerEngine, builds
+// the FolderIndex from the result and replays typed queries against it the
+// way the match worker does. Results are written with SavePerfReport, so
+// the JSON has the same layout as the launcher's own perf_report.json and
+// two builds can be compared with a plain diff.
+//
+//   crawl_bench [--dirs N] [--fanout N] [--depth N] [--hidden RATIO]
+//               [--projects RATIO] [--bloat N] [--seed N]
+//               [--tree DIR] [--keep] [--workers N] [--crawl-depth N]
+//               [--stop-at-projects] [--project-depth N] [--exclude PATTERN]...
+//               [--passes N] [--query TEXT]... [--out FILE]
+//
+// Without --tree the tree is generated in a temporary folder and removed
+// afterwards. An existing --tree folder is crawled as it is.
+
+#include "benchutil.hpp"
+#include "treegen.hpp"
+
+#include "crawler.hpp"
+#include "excludes.hpp"
+#include "folderindex.hpp"
+#include "matchengine.hpp"
+#include "matcher.hpp"
+#include "perfreport.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+static const size_t resultLimit = 50;
+
+// Feeds query one keystroke at a time through a CandidateCache, so later
+// keystrokes only rescore the previous survivors, as in the launcher.
+static void ReplayQuery(const FolderIndex& index, const std::string& query, MatchPerf& perf) {
+    std::vector<IdRange> view { { 0, (uint32_t)index.Size() } };
+    CandidateCache cache;
+    for (size_t typed = 1; typed <= query.size(); ++typed) {
+        auto start = BenchClock::now();
+        std::string lowerInput = LowerPattern(query.substr(0, typed));
+        bool exact = lowerInput[0] == '\'';
+        std::string_view pattern = exact ? std::string_view(lowerInput).substr(1) : std::string_view(lowerInput);
+        if (pattern.empty()) continue;
+
+        const std::vector<uint32_t>* candidates = cache.Narrow(lowerInput);
+        std::vector<uint32_t> trigramCandidates;
+        if (exact && index.TrigramCandidates(pattern, trigramCandidates)) {
+            if (!candidates || trigramCandidates.size() < candidates->size()) candidates = &trigramCandidates;
+        }
+
+        IndexMatchOptions options;
+        options.lowerPattern = pattern;
+        options.exact = exact;
+        options.limit = resultLimit;
+        IndexMatchResult result;
+        MatchIndex(index, view, candidates, options, result);
+        perf.Record(ElapsedMs(start), result.visited, index.Size());
+        cache.Store(lowerInput, std::move(result.survivors));
+    }
+}
+
+static bool IsDirectory(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+int main(int argc, char** argv) {
+    BenchArgs args(argc, argv);
+
+    TreeShape shape;
+    shape.directories = args.Size("--dirs", shape.directories);
+    shape.fanOut = (int)args.Size("--fanout", shape.fanOut);
+    shape.maxDepth = (int)args.Size("--depth", shape.maxDepth);
+    shape.hiddenRatio = args.Number("--hidden", shape.hiddenRatio);
+    shape.projectRatio = args.Number("--projects", shape.projectRatio);
+    shape.bloatPackages = (int)args.Size("--bloat", shape.bloatPackages);
+    shape.seed = (uint32_t)args.Size("--seed", shape.seed);
+    std::string tree = args.Text("--tree", "");
+    bool keep = args.Flag("--keep");
+
+    ExcludeRules excludes;
+    excludes.Compile(args.List("--exclude"));
+    CrawlOptions options;
+    options.maxDepth = (int)args.Size("--crawl-depth", 64);
+    options.maxAdaptiveDepth = options.maxDepth;
+    options.stopAtProjects = args.Flag("--stop-at-projects");
+    options.projectDepth = (int)args.Size("--project-depth", 0);
+    options.excludes = &excludes;
+    options.workerCount = (unsigned int)args.Size("--workers", 0);
+    options.timeBudgetMs = std::numeric_limits<uint32_t>::max();
+    options.entryBudget = std::numeric_limits<size_t>::max();
+    size_t passes = std::max<size_t>(args.Size("--passes", 1), 1);
+
+    std::vector<std::string> queries = args.List("--query");
+    if (queries.empty()) queries = { "src", "kinesis", "reportsarch", "'node_modules", "'widget-" };
+    std::string out = args.Text("--out", "crawl_bench.json");
+    if (!args.CheckAllUsed()) return 2;
+
+    bool isGenerated = tree.empty() || !IsDirectory(tree);
+    std::string generatedRoot = tree;
+    if (tree.empty()) {
+        char pattern[] = "/tmp/kinesis-tree-XXXXXX";
+        if (!mkdtemp(pattern)) {
+            std::perror("mkdtemp");
+            return 1;
+        }
+        generatedRoot = pattern;
+        tree = generatedRoot + "/root";
+    }
+    if (isGenerated) {
+        TreeStats stats;
+        auto start = BenchClock::now();
+        if (!GenerateTree(tree, shape, stats)) {
+            std::perror("generate");
+            return 1;
+        }
+        std::printf("generated %zu folders (%zu hidden, %zu projects, %zu in node_modules) in %.0f ms\n",
+                    stats.directories, stats.hidden, stats.projects, stats.bloat, ElapsedMs(start));
+    }
+
+    // Passes after the first reuse the engine's directory cache, like the
+    // launcher's later consistency crawls.
+    CrawlerEngine engine(NativeFileSystem());
+    CrawlPerf crawlPerf;
+    FolderIndex index;
+    for (size_t pass = 0; pass < passes; ++pass) {
+        auto crawlStart = BenchClock::now();
+        CrawlResult crawl = engine.Crawl({ tree }, options);
+        auto buildStart = BenchClock::now();
+        index.Build(crawl.folders);
+        auto buildEnd = BenchClock::now();
+
+        crawlPerf = CrawlPerf();
+        crawlPerf.wallMs = (uint64_t)ElapsedMs(crawlStart, buildStart);
+        crawlPerf.buildMs = (uint64_t)ElapsedMs(buildStart, buildEnd);
+        crawlPerf.directories = crawl.folders.size();
+        crawlPerf.directoriesPerSecond = crawlPerf.directories * 1000.0 / std::max(ElapsedMs(crawlStart, buildStart), 1e-3);
+        crawlPerf.indexBytes = index.ByteSize();
+        crawlPerf.roots = std::move(crawl.stats);
+        std::printf("pass %zu: %zu folders in %llu ms (%.0f/s), index %zu bytes built in %llu ms, "
+                    "directory cache %zu bytes\n", pass + 1, crawlPerf.directories, (unsigned long long)crawlPerf.wallMs,
+                    crawlPerf.directoriesPerSecond, crawlPerf.indexBytes, (unsigned long long)crawlPerf.buildMs,
+                    engine.CacheByteSize());
+    }
+
+    MatchPerf matchPerf;
+    for (const auto& query : queries) ReplayQuery(index, query, matchPerf);
+    std::printf("match: %llu keystrokes, %.3f ms average, %.3f ms max\n", (unsigned long long)matchPerf.queries,
+                matchPerf.queries ? matchPerf.totalMs / matchPerf.queries : 0.0, matchPerf.maxMs);
+    std::printf("peak memory: %zu bytes\n", PeakMemoryBytes());
+
+    bool saved = SavePerfReport(out, crawlPerf, matchPerf, LaunchPerf(), ShowPerf());
+    if (isGenerated && !keep) RemoveTree(generatedRoot);
+    else if (isGenerated) std::printf("kept tree at %s\n", tree.c_str());
+    if (!saved) {
+        std::fprintf(stderr, "could not write %s\n", out.c_str());
+        return 1;
+    }
+    std::printf("wrote %s\n", out.c_str());
+    return 0;
+}
@@ -0,0 +1,61 @@
+// Times ScaleAndFade on a logo-sized image at the sizes the launcher window
+// is drawn at. The launcher only pays this once per window size, so the
+// figure to watch is how long a resize stalls the first paint. Timings are
+// written as stages with SaveStartupReport.
+//
+//   image_bench [--source N] [--size N]... [--rounds N] [--out FILE]
+
+#include "benchutil.hpp"
+
+#include "imagekernel.hpp"
+#include "perfreport.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    BenchArgs args(argc, argv);
+    int sourceSize = (int)args.Size("--source", 512);
+    std::vector<std::string> sizeArgs = args.List("--size");
+    size_t rounds = std::max<size_t>(args.Size("--rounds", 20), 1);
+    std::string out = args.Text("--out", "image_bench.json");
+    if (!args.CheckAllUsed()) return 2;
+
+    std::vector<int> sizes;
+    for (const auto& size : sizeArgs) sizes.push_back(std::atoi(size.c_str()));
+    if (sizes.empty()) sizes = { 128, 256, 400, 600, 1024 };
+
+    // A disc on a transparent background, like the logo.
+    PixelBuffer source;
+    source.width = source.height = sourceSize;
+    source.pixels.resize((size_t)sourceSize * sourceSize);
+    for (int y = 0; y < sourceSize; ++y) {
+        for (int x = 0; x < sourceSize; ++x) {
+            int dx = x - sourceSize / 2;
+            int dy = y - sourceSize / 2;
+            bool inside = dx * dx + dy * dy < sourceSize * sourceSize / 5;
+            source.pixels[(size_t)y * sourceSize + x] = inside ? 0xFF3080F0u : 0x00FFFFFFu;
+        }
+    }
+
+    auto origin = BenchClock::now();
+    std::vector<StageTiming> stages;
+    PixelBuffer target;
+    for (int size : sizes) {
+        auto start = BenchClock::now();
+        for (size_t round = 0; round < rounds; ++round) ScaleAndFade(source, size, size, 0.12f, target);
+        double ms = ElapsedMs(start) / rounds;
+        stages.push_back({ std::to_string(sourceSize) + " to " + std::to_string(size), ElapsedMs(origin, start), ms });
+        std::printf("%d -> %-5d %8.3f ms\n", sourceSize, size, ms);
+    }
+
+    if (!SaveStartupReport(out, stages)) {
+        std::fprintf(stderr, "could not write %s\n", out.c_str());
+        return 1;
+    }
+    std::printf("wrote %s\n", out.c_str());
+    return 0;
+}
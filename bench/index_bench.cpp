@@ -0,0 +1,196 @@
+// Builds a FolderIndex from synthetic paths, saves it and times opening the
+// snapshot the way the launcher does at startup, followed by the first full
+// scan that pages the mapping in, and replacing one folder the way a
+// watcher delta does. The same paths held as a plain
+// std::vector<std::string> are measured alongside as the baseline: heap
+// bytes, resident peak and one single-threaded fuzzy scan for each side.
+// Stages are written with SaveStartupReport, the same layout as the
+// launcher's startup_report.json.
+//
+//   index_bench [--paths N] [--opens N] [--query TEXT] [--seed N] [--out FILE]
+
+#include "benchutil.hpp"
+#include "synthetic.hpp"
+
+#include "folderindex.hpp"
+#include "matchengine.hpp"
+#include "matcher.hpp"
+#include "perfreport.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <malloc.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Heap bytes of the vector: its slots plus every string too long for the
+// small string buffer, which allocates capacity + 1 bytes of its own.
+static size_t VectorBytes(const std::vector<std::string>& paths) {
+    size_t bytes = paths.capacity() * sizeof(std::string);
+    std::string empty;
+    for (const auto& path : paths) {
+        if (path.capacity() > empty.capacity()) bytes += path.capacity() + 1;
+    }
+    return bytes;
+}
+
+// The kernel's resident high-water mark can be reset through clear_refs, so
+// each side's peak covers only the time that side alone is resident.
+static void ResetPeakResident() {
+    std::ofstream("/proc/self/clear_refs") << "5";
+}
+
+static size_t StatusBytes(const char* key) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    size_t keyLength = std::strlen(key);
+    while (std::getline(status, line)) {
+        if (line.compare(0, keyLength, key) == 0) {
+            return (size_t)std::strtoull(line.c_str() + keyLength, nullptr, 10) * 1024;
+        }
+    }
+    return 0;
+}
+
+struct SideStats {
+    size_t bytes = 0;
+    size_t peak = 0;
+    double scanMs = 0.0;
+    size_t matches = 0;
+};
+
+int main(int argc, char** argv) {
+    BenchArgs args(argc, argv);
+    size_t pathCount = args.Size("--paths", 1000000);
+    size_t opens = std::max<size_t>(args.Size("--opens", 20), 1);
+    std::string query = LowerPattern(args.Text("--query", "kinesis"));
+    uint32_t seed = (uint32_t)args.Size("--seed", 42);
+    std::string out = args.Text("--out", "index_bench.json");
+    if (!args.CheckAllUsed()) return 2;
+
+    char directory[] = "/tmp/kinesis-index-XXXXXX";
+    if (!mkdtemp(directory)) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+    std::string snapshot = std::string(directory) + "/folders.idx";
+
+    auto origin = BenchClock::now();
+    std::vector<StageTiming> stages;
+    auto stage = [&](const char* name, BenchClock::time_point start) {
+        stages.push_back({ name, ElapsedMs(origin, start), ElapsedMs(start) });
+        std::printf("%-12s %10.3f ms\n", name, stages.back().durationMs);
+    };
+
+    // Peaks are counted above the resident size each side starts from. The
+    // strings' peak includes generating them, which needs a set to drop
+    // duplicates much as a crawler has to.
+    ResetPeakResident();
+    size_t residentBefore = StatusBytes("VmRSS:");
+    auto start = BenchClock::now();
+    std::vector<std::string> paths = SyntheticPaths(pathCount, seed);
+    stage("generate", start);
+
+    // The baseline scan lowercases each path before matching it, as a matcher
+    // over plain strings has to unless it keeps a second lowercase copy.
+    SideStats strings;
+    strings.bytes = VectorBytes(paths);
+    start = BenchClock::now();
+    std::string lowerPath;
+    for (const auto& path : paths) {
+        lowerPath = LowerPattern(path);
+        size_t slash = path.find_last_of('\\');
+        int score;
+        strings.matches += FuzzyMatch(query, path, lowerPath, slash == std::string::npos ? 0 : slash + 1, score);
+    }
+    stage("string scan", start);
+    strings.scanMs = stages.back().durationMs;
+    strings.peak = StatusBytes("VmHWM:") - residentBefore;
+
+    start = BenchClock::now();
+    FolderIndex built;
+    built.Build(paths);
+    stage("build", start);
+
+    // A watcher delta: one folder is replaced by a renamed copy.
+    start = BenchClock::now();
+    {
+        FolderIndex replaced;
+        std::string moved = built.Path(built.Size() / 2);
+        replaced.BuildReplaced(built, { built.PrefixRange(moved) }, { moved + "-renamed" });
+    }
+    stage("replace", start);
+
+    start = BenchClock::now();
+    bool saved = built.Save(snapshot);
+    stage("save", start);
+    if (!saved) {
+        std::fprintf(stderr, "could not write %s\n", snapshot.c_str());
+        return 1;
+    }
+    built.Clear();
+    std::vector<std::string>().swap(paths);
+    malloc_trim(0);
+    ResetPeakResident();
+    residentBefore = StatusBytes("VmRSS:");
+
+    // Opening only maps and validates the file, so it is repeated to get a
+    // stable figure; the slowest open is reported separately.
+    FolderIndex loaded;
+    double totalOpenMs = 0.0;
+    double maxOpenMs = 0.0;
+    for (size_t i = 0; i < opens; ++i) {
+        start = BenchClock::now();
+        if (!loaded.Load(snapshot)) {
+            std::fprintf(stderr, "could not open %s\n", snapshot.c_str());
+            return 1;
+        }
+        double openMs = ElapsedMs(start);
+        totalOpenMs += openMs;
+        maxOpenMs = std::max(maxOpenMs, openMs);
+    }
+    stages.push_back({ "open", ElapsedMs(origin, start), totalOpenMs / opens });
+    stages.push_back({ "open max", ElapsedMs(origin, start), maxOpenMs });
+    std::printf("%-12s %10.3f ms average, %.3f ms max over %zu opens\n", "open", totalOpenMs / opens, maxOpenMs, opens);
+
+    start = BenchClock::now();
+    FolderIndex::Decoder decoder(loaded);
+    size_t bytes = 0;
+    for (size_t i = 0; i < loaded.Size(); ++i) {
+        decoder.Seek(i);
+        bytes += decoder.Path().size();
+    }
+    stage("first scan", start);
+
+    SideStats index;
+    index.bytes = loaded.ByteSize();
+    start = BenchClock::now();
+    IndexMatchOptions options;
+    options.lowerPattern = query;
+    options.threadCount = 1;
+    IndexMatchResult result;
+    MatchIndex(loaded, { { 0, (uint32_t)loaded.Size() } }, nullptr, options, result);
+    stage("index scan", start);
+    index.scanMs = stages.back().durationMs;
+    index.matches = result.survivors.size();
+    index.peak = StatusBytes("VmHWM:") - residentBefore;
+
+    std::printf("%zu paths, %zu path bytes\n", loaded.Size(), bytes);
+    std::printf("%-8s %14s %14s %12s %10s\n", "", "bytes", "peak growth", "scan ms", "matches");
+    std::printf("%-8s %14zu %14zu %12.3f %10zu\n", "strings", strings.bytes, strings.peak, strings.scanMs,
+                strings.matches);
+    std::printf("%-8s %14zu %14zu %12.3f %10zu\n", "index", index.bytes, index.peak, index.scanMs, index.matches);
+
+    loaded.Clear();
+    std::remove(snapshot.c_str());
+    rmdir(directory);
+    if (!SaveStartupReport(out, stages)) {
+        std::fprintf(stderr, "could not write %s\n", out.c_str());
+        return 1;
+    }
+    std::printf("wrote %s\n", out.c_str());
+    return 0;
+}
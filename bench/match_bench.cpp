@@ -0,0 +1,88 @@
+// Rescores a synthetic folder index on every keystroke of a few typed
+// queries, the way the launcher's match worker does. Without --cached every
+// keystroke scans the whole index, which is the worst case the matcher has
+// to keep interactive. Results are written with SavePerfReport.
+//
+//   match_bench [--paths N] [--threads N] [--cached] [--exact]
+//               [--query TEXT]... [--seed N] [--out FILE]
+
+#include "benchutil.hpp"
+#include "synthetic.hpp"
+
+#include "folderindex.hpp"
+#include "matchengine.hpp"
+#include "matcher.hpp"
+#include "perfreport.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static const size_t resultLimit = 50;
+
+int main(int argc, char** argv) {
+    BenchArgs args(argc, argv);
+    size_t pathCount = args.Size("--paths", 500000);
+    unsigned int threads = (unsigned int)args.Size("--threads", 0);
+    bool cached = args.Flag("--cached");
+    bool exact = args.Flag("--exact");
+    bool trigrams = args.Flag("--trigrams");
+    uint32_t seed = (uint32_t)args.Size("--seed", 42);
+    std::vector<std::string> queries = args.List("--query");
+    if (queries.empty()) queries = { "kinesis", "srcwidget", "photos2023", "wslcoreapi", "desktopbuild" };
+    std::string out = args.Text("--out", "match_bench.json");
+    if (!args.CheckAllUsed()) return 2;
+
+    CrawlPerf crawlPerf;
+    FolderIndex index;
+    {
+        std::vector<std::string> paths = SyntheticPaths(pathCount, seed);
+        auto start = BenchClock::now();
+        index.Build(paths);
+        crawlPerf.buildMs = (uint64_t)ElapsedMs(start);
+    }
+    crawlPerf.directories = index.Size();
+    crawlPerf.indexBytes = index.ByteSize();
+    std::printf("%zu paths, index %zu bytes built in %llu ms\n", index.Size(), index.ByteSize(),
+                (unsigned long long)crawlPerf.buildMs);
+
+    std::vector<IdRange> view { { 0, (uint32_t)index.Size() } };
+    MatchPerf matchPerf;
+    for (const auto& query : queries) {
+        CandidateCache cache;
+        double queryMs = 0.0;
+        size_t lastMatches = 0;
+        for (size_t typed = 1; typed <= query.size(); ++typed) {
+            auto start = BenchClock::now();
+            std::string lowerInput = LowerPattern(query.substr(0, typed));
+            IndexMatchOptions options;
+            options.lowerPattern = lowerInput;
+            options.exact = exact;
+            options.limit = resultLimit;
+            options.threadCount = threads;
+            const std::vector<uint32_t>* candidates = cached ? cache.Narrow(lowerInput) : nullptr;
+            std::vector<uint32_t> trigramCandidates;
+            if (exact && trigrams && index.TrigramCandidates(lowerInput, trigramCandidates)) {
+                if (!candidates || trigramCandidates.size() < candidates->size()) candidates = &trigramCandidates;
+            }
+            IndexMatchResult result;
+            MatchIndex(index, view, candidates, options, result);
+            double elapsedMs = ElapsedMs(start);
+            matchPerf.Record(elapsedMs, result.visited, index.Size());
+            queryMs += elapsedMs;
+            lastMatches = result.survivors.size();
+            if (cached) cache.Store(lowerInput, std::move(result.survivors));
+        }
+        std::printf("%-20s %8.3f ms per keystroke, %8.3f ms on the last keystroke, %zu matches\n", query.c_str(),
+                    queryMs / query.size(), matchPerf.lastMs, lastMatches);
+    }
+    std::printf("match: %llu keystrokes, %.3f ms average, %.3f ms max\n", (unsigned long long)matchPerf.queries,
+                matchPerf.queries ? matchPerf.totalMs / matchPerf.queries : 0.0, matchPerf.maxMs);
+
+    if (!SavePerfReport(out, crawlPerf, matchPerf, LaunchPerf(), ShowPerf())) {
+        std::fprintf(stderr, "could not write %s\n", out.c_str());
+        return 1;
+    }
+    std::printf("wrote %s\n", out.c_str());
+    return 0;
+}
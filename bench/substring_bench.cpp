@@ -0,0 +1,84 @@
+// Times the substring search over every lowercase path of a synthetic
+// index three ways: std::string_view::find as the launcher used to, the
+// runtime-selected FindSubstring kernel, and the kernel behind the CharMask
+// prefilter the way MatchIndex calls it. Timings are written as stages
+// with SaveStartupReport.
+//
+//   substring_bench [--paths N] [--rounds N] [--query TEXT]... [--seed N] [--out FILE]
+
+#include "benchutil.hpp"
+#include "synthetic.hpp"
+
+#include "matcher.hpp"
+#include "perfreport.hpp"
+#include "substring.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    BenchArgs args(argc, argv);
+    size_t pathCount = args.Size("--paths", 1000000);
+    size_t rounds = std::max<size_t>(args.Size("--rounds", 5), 1);
+    uint32_t seed = (uint32_t)args.Size("--seed", 42);
+    std::vector<std::string> queries = args.List("--query");
+    if (queries.empty()) queries = { "kinesis", "widget", "photos2023", "gamma17\\core", "zq", "onedrive - company" };
+    std::string out = args.Text("--out", "substring_bench.json");
+    if (!args.CheckAllUsed()) return 2;
+
+    std::vector<std::string> lowerPaths = SyntheticPaths(pathCount, seed);
+    std::vector<uint64_t> masks;
+    masks.reserve(lowerPaths.size());
+    for (auto& path : lowerPaths) {
+        path = LowerPattern(path);
+        masks.push_back(CharMask(path));
+    }
+    std::printf("%zu paths, kernel %s\n", lowerPaths.size(), SubstringKernelName());
+
+    auto origin = BenchClock::now();
+    std::vector<StageTiming> stages;
+    for (const auto& query : queries) {
+        std::string pattern = LowerPattern(query);
+        uint64_t patternMask = CharMask(pattern);
+        size_t hits[3] = {};
+        double ms[3] = {};
+        for (size_t round = 0; round < rounds; ++round) {
+            auto start = BenchClock::now();
+            hits[0] = 0;
+            for (const auto& path : lowerPaths) hits[0] += std::string_view(path).find(pattern) != std::string_view::npos;
+            ms[0] += ElapsedMs(start);
+
+            start = BenchClock::now();
+            hits[1] = 0;
+            for (const auto& path : lowerPaths) hits[1] += FindSubstring(path, pattern) != std::string_view::npos;
+            ms[1] += ElapsedMs(start);
+
+            start = BenchClock::now();
+            hits[2] = 0;
+            for (size_t i = 0; i < lowerPaths.size(); ++i) {
+                hits[2] += CouldMatch(patternMask, masks[i]) && FindSubstring(lowerPaths[i], pattern) != std::string_view::npos;
+            }
+            ms[2] += ElapsedMs(start);
+        }
+        if (hits[0] != hits[1] || hits[0] != hits[2]) {
+            std::fprintf(stderr, "\"%s\": kernels disagree (%zu, %zu, %zu hits)\n", query.c_str(), hits[0], hits[1], hits[2]);
+            return 1;
+        }
+
+        const char* names[3] = { "find", SubstringKernelName(), "mask+kernel" };
+        for (int k = 0; k < 3; ++k) {
+            stages.push_back({ std::string(names[k]) + " " + query, ElapsedMs(origin), ms[k] / rounds });
+        }
+        std::printf("%-20s %7zu hits: find %7.2f ms, %s %7.2f ms, mask+%s %7.2f ms\n", query.c_str(), hits[0],
+                    ms[0] / rounds, SubstringKernelName(), ms[1] / rounds, SubstringKernelName(), ms[2] / rounds);
+    }
+
+    if (!SaveStartupReport(out, stages)) {
+        std::fprintf(stderr, "could not write %s\n", out.c_str());
+        return 1;
+    }
+    std::printf("wrote %s\n", out.c_str());
+    return 0;
+}
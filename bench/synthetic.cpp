@@ -0,0 +1,44 @@
+#include "synthetic.hpp"
+
+#include <algorithm>
+#include <random>
+#include <unordered_set>
+
+static const char* const pathWords[] = {
+    "src", "include", "docs", "test", "build", "alpha", "beta", "gamma", "project", "kinesis",
+    "Widget", "core", "util", "assets", "Images", "Photos2023", "node", "server", "client", "api"
+};
+
+static const char* const pathRoots[] = {
+    "C:\\Users\\me\\OneDrive - Company\\Documents",
+    "\\\\wsl.localhost\\Ubuntu\\home\\me",
+    "C:\\Users\\me\\Desktop"
+};
+
+static const size_t maxSeparators = 9;
+
+std::vector<std::string> SyntheticPaths(size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<std::string> paths;
+    std::unordered_set<std::string> seen;
+    paths.reserve(count);
+    seen.reserve(count);
+
+    std::vector<std::string> frontier(std::begin(pathRoots), std::end(pathRoots));
+    size_t generated = 0;
+    while (paths.size() < count) {
+        std::string path = frontier[rng() % frontier.size()];
+        int folders = 1 + (int)(rng() % 2);
+        for (int i = 0; i < folders; ++i) {
+            path += '\\';
+            path += pathWords[rng() % 20];
+            if (rng() % 3 == 0) path += std::to_string(rng() % 100);
+        }
+        if (!seen.insert(path).second) continue;
+        if (generated++ % 3 == 0 && (size_t)std::count(path.begin(), path.end(), '\\') < maxSeparators) {
+            frontier.push_back(path);
+        }
+        paths.push_back(std::move(path));
+    }
+    return paths;
+}
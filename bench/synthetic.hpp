@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Distinct Windows-style folder paths below a few long roots (OneDrive,
+// a WSL home, the desktop), grown the way real trees are: every path
+// extends an earlier one by one or two folder names, so the sorted list
+// shares long prefixes like a crawl result does. The same seed always
+// gives the same paths, in generation order.
+std::vector<std::string> SyntheticPaths(size_t count, uint32_t seed = 42);
@@ -0,0 +1,110 @@
+#include "treegen.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <random>
+#include <system_error>
+
+#include <sys/stat.h>
+
+static const char* const folderWords[] = {
+    "src", "include", "docs", "test", "build", "assets", "scripts", "config", "tools", "lib",
+    "Projects", "Work", "Photos", "Invoices", "Reports", "Archive", "clients", "server", "api", "web",
+    "kinesis", "widget", "core", "util", "design", "notes", "backup", "Drafts", "research", "data"
+};
+
+static const char* const hiddenWords[] = { ".cache", ".config", ".vscode", ".idea", ".local", ".npm" };
+
+static const char* const packageWords[] = {
+    "react", "lodash", "webpack", "babel-core", "typescript", "eslint", "chalk", "express", "jest", "rollup"
+};
+
+struct TreeGenerator {
+    const TreeShape& shape;
+    TreeStats& stats;
+    std::mt19937 rng;
+
+    TreeGenerator(const TreeShape& shape, TreeStats& stats) : shape(shape), stats(stats), rng(shape.seed) {}
+
+    bool HasBudget() const { return stats.directories < shape.directories; }
+
+    bool Roll(double ratio) { return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < ratio; }
+
+    bool MakeFolder(const std::string& path) {
+        if (mkdir(path.c_str(), 0755) != 0) return false;
+        ++stats.directories;
+        return true;
+    }
+
+    bool MakeMarker(const std::string& folder) {
+        FILE* file = fopen((folder + "/package.json").c_str(), "w");
+        if (!file) return false;
+        fputs("{}\n", file);
+        fclose(file);
+        return true;
+    }
+
+    // node_modules/<package>/{lib,dist}, with the occasional nested
+    // node_modules the way npm leaves conflicting versions behind.
+    bool MakeBloat(const std::string& project) {
+        std::string modules = project + "/node_modules";
+        if (!HasBudget()) return true;
+        if (!MakeFolder(modules)) return false;
+        ++stats.bloat;
+        for (int p = 0; p < shape.bloatPackages && HasBudget(); ++p) {
+            std::string package = modules + "/" + packageWords[p % 10] + "-" + std::to_string(p);
+            if (!MakeFolder(package)) return false;
+            ++stats.bloat;
+            const char* parts[] = { "lib", "dist", "node_modules" };
+            int partCount = Roll(0.1) ? 3 : 2;
+            for (int i = 0; i < partCount && HasBudget(); ++i) {
+                if (!MakeFolder(package + "/" + parts[i])) return false;
+                ++stats.bloat;
+            }
+        }
+        return true;
+    }
+
+    bool Run(const std::string& root) {
+        if (!MakeFolder(root)) return false;
+
+        std::deque<std::pair<std::string, int>> queue;
+        queue.push_back({ root, 0 });
+        std::uniform_int_distribution<int> childCount(1, std::max(2 * shape.fanOut - 1, 1));
+        while (!queue.empty() && HasBudget()) {
+            std::string parent = std::move(queue.front().first);
+            int depth = queue.front().second;
+            queue.pop_front();
+            if (depth >= shape.maxDepth) continue;
+
+            int children = childCount(rng);
+            for (int i = 0; i < children && HasBudget(); ++i) {
+                bool isHidden = Roll(shape.hiddenRatio);
+                std::string name = isHidden ? hiddenWords[rng() % 6] : folderWords[rng() % 30];
+                std::string path = parent + "/" + name + "-" + std::to_string(i);
+                if (!MakeFolder(path)) return false;
+                if (isHidden) ++stats.hidden;
+
+                if (depth > 0 && !isHidden && Roll(shape.projectRatio)) {
+                    if (!MakeMarker(path) || !MakeBloat(path)) return false;
+                    ++stats.projects;
+                }
+                queue.push_back({ std::move(path), depth + 1 });
+            }
+        }
+        return true;
+    }
+};
+
+bool GenerateTree(const std::string& root, const TreeShape& shape, TreeStats& stats) {
+    stats = TreeStats();
+    TreeGenerator generator(shape, stats);
+    return generator.Run(root);
+}
+
+void RemoveTree(const std::string& root) {
+    std::error_code error;
+    std::filesystem::remove_all(root, error);
+}
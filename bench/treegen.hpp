@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Shape of a synthetic folder tree. Every folder gets between 1 and
+// 2 * fanOut - 1 subfolders until the directory budget runs out or depth
+// reaches maxDepth. A share of the folders is hidden (dot-prefixed), and a
+// share becomes a project: it gets a package.json marker and a
+// node_modules folder holding bloatPackages packages with a few folders
+// each, the way an installed JavaScript project looks on disk.
+struct TreeShape {
+    size_t directories = 10000;
+    int fanOut = 6;
+    int maxDepth = 8;
+    double hiddenRatio = 0.03;
+    double projectRatio = 0.01;
+    int bloatPackages = 40;
+    uint32_t seed = 42;
+};
+
+struct TreeStats {
+    size_t directories = 0;
+    size_t hidden = 0;
+    size_t projects = 0;
+    size_t bloat = 0;
+};
+
+// Creates the tree below root, which must not exist yet. Returns false if
+// a folder could not be created.
+bool GenerateTree(const std::string& root, const TreeShape& shape, TreeStats& stats);
+
+// Deletes root and everything below it.
+void RemoveTree(const std::string& root);
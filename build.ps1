@@ -20,7 +20,8 @@ $LDLibs = @(
     "-lshlwapi",
     "-luuid",
     "-pthread",
-    "-lgdiplus"
+    "-lgdiplus",
+    "-lmsimg32"
 )
 
 if ($Release) {
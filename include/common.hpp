@@ -17,14 +17,20 @@
 #include <iostream>
 #include <vector>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 #include <string>
 #include <sstream>
 #include <cmath>
+#include <ctime>
 #include <fstream>
 #include <thread>
+#include <chrono>
 #include <atomic>
 #include <mutex>
+#include <condition_variable>
+#include <memory>
 #include <filesystem>
 
 std::string ToUpper(std::string s);
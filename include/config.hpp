@@ -4,11 +4,29 @@ namespace Config {
     extern bool enableTabSwitcher;
     extern std::set<std::string> tabbedApps;
 
-    extern bool enableVSCodeLauncher;
-    extern unsigned int VSCodeLauncherKey;
+    // One entry of the "launchers" list, opened with Ctrl + Alt + key. The
+    // logo is a resource number or an image file. Command items are single
+    // arguments, a leading "-flag " kept apart so it is dropped with an
+    // empty value; environment items are "NAME=value".
+    struct LauncherSettings {
+        std::string name;
+        bool enabled = true;
+        unsigned int key = 0;
+        std::string history;
+        std::string logo;
+        std::string placeholder;
+        std::vector<std::string> engine;
+        std::vector<std::string> include;
+        std::vector<std::string> exclude;
+        std::vector<std::string> command;
+        std::vector<std::string> environment;
+    };
+    extern std::vector<LauncherSettings> launchers;
 
-    extern bool enableWSLTerminalLauncher;
-    extern unsigned int WSLTerminalLauncherKey;
+    extern bool projectRootCrawl;
+    extern int projectSubFolderDepth;
+    extern std::vector<std::string> crawlerRoots;
+    extern std::vector<std::string> crawlerExcludes;
 
     extern bool enableTaskSwitcher;
     extern unsigned int allAppsSwitcherMod;
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "excludes.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct CrawlListing {
+    std::vector<std::string> subdirectories;
+    bool isProject = false;
+};
+
+class CrawlFileSystem {
+public:
+    virtual ~CrawlFileSystem() = default;
+
+    virtual char Separator() const = 0;
+    virtual bool GetLastWriteTime(const std::string& path, uint64_t& lastWriteTime) = 0;
+    virtual void ListDirectory(const std::string& path, CrawlListing& listing) = 0;
+
+    // Whether ListDirectory on the parent would report path as one of its
+    // subdirectories, for folders that are reached without listing the
+    // parent, such as one the watcher reports.
+    virtual bool IsListedFolder(const std::string& path) = 0;
+};
+
+bool IsProjectMarker(const char* name);
+
+CrawlFileSystem& NativeFileSystem();
+
+// Directory records kept between crawls of one root, laid out as a tree.
+// Every directory's children are one run of entries sorted by name, and
+// each distinct child name is stored once in a shared pool, however many
+// folders use it. A crawl task carries the record of its own directory, so
+// a directory is found without hashing or storing its full path.
+struct CrawlDirTree {
+    static const uint32_t none = 0xFFFFFFFF;
+
+    struct Dir {
+        uint64_t lastWriteTime;
+        uint32_t firstChild;
+        uint32_t childCount : 31;
+        uint32_t isProject : 1;
+    };
+
+    // dir is the child's own record, or none if it was never crawled.
+    struct Child {
+        uint32_t name;
+        uint32_t dir;
+    };
+
+    uint32_t root = none;
+    std::vector<Dir> dirs;
+    std::vector<Child> children;
+    std::vector<char> names;
+
+    const char* Name(const Child& child) const { return names.data() + child.name; }
+    uint32_t FindChild(uint32_t dir, const char* name) const;
+    size_t ByteSize() const;
+};
+
+using CrawlBatchCallback = std::function<void(const std::vector<std::string>& batch)>;
+
+struct CrawlRootStats;
+using CrawlRootCallback = std::function<void(const CrawlRootStats& stats, const std::vector<std::string>& folders)>;
+
+// Excluded folders are pruned as they are reached, so cached directory
+// records keep every child and a rule change takes effect on the next crawl.
+// With stopAtProjects, a folder holding a project marker is indexed as one
+// entry and only its first projectDepth levels of subfolders are added.
+// Every root is crawled as its own job with its own queue and workers.
+// maxDepth is the starting depth; later crawls move it between minDepth
+// and maxAdaptiveDepth depending on how the previous crawl went. When
+// onBatch is set, each worker hands over its newly found folders every
+// batchSize entries. Calls are serialized but come from the worker
+// threads, and may repeat folders reached through overlapping roots.
+// onRootDone gets every folder of one root as soon as that root's job is
+// finished, while slower roots are still crawling. Its calls are serialized
+// as well and all of them happen before Crawl returns. Once isCancelled
+// returns true the workers stop taking tasks, the result is partial and
+// marked cancelled, and the engine keeps its previous records.
+struct CrawlOptions {
+    int maxDepth = 5;
+    int minDepth = 2;
+    int maxAdaptiveDepth = 8;
+    bool stopAtProjects = false;
+    int projectDepth = 0;
+    const ExcludeRules* excludes = nullptr;
+    unsigned int workerCount = 0;
+    uint32_t timeBudgetMs = 15000;
+    size_t entryBudget = 250000;
+    size_t batchSize = 256;
+    CrawlBatchCallback onBatch;
+    CrawlRootCallback onRootDone;
+    std::function<bool()> isCancelled;
+};
+
+struct CrawlRootStats {
+    std::string root;
+    size_t entries = 0;
+    uint64_t elapsedMs = 0;
+    int depth = 0;
+    bool truncated = false;
+    bool timedOut = false;
+};
+
+struct CrawlResult {
+    std::vector<std::string> folders;
+    std::vector<CrawlRootStats> stats;
+    bool cancelled = false;
+};
+
+class CrawlerEngine {
+public:
+    explicit CrawlerEngine(CrawlFileSystem& fileSystem) : fs(fileSystem) {}
+
+    CrawlResult Crawl(const std::vector<std::string>& roots, const CrawlOptions& options);
+
+    // Bytes held by the directory records of every root.
+    size_t CacheByteSize() const;
+
+private:
+    struct RootState {
+        int depth = 0;
+        CrawlDirTree dirTree;
+    };
+
+    CrawlFileSystem& fs;
+    std::unordered_map<std::string, RootState> rootStates;
+};
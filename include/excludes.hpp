@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// Gitignore-style folder excludes, compiled once per crawl. Patterns
+// without a slash ("target", "build-*", "**/.venv") are tested against the
+// folder name: plain names go into a hash set, the rest are name globs.
+// Patterns with a slash are globs over path segments, with '\' and '/'
+// both taken as separators:
+//   "/mnt/c/**"       a leading '/' anchors to the crawl root, so this is
+//                     everything below <root>/mnt/c on a WSL root;
+//   "C:/Users/*/tmp"  a drive letter or a leading "//" (a UNC share)
+//                     anchors to the start of the full path;
+//   "build/out"       anything else floats and matches the end of the path.
+// '*' and '?' stay within one segment. '**' as a whole segment matches any
+// number of segments, at least one when it ends the pattern, and like '*'
+// anywhere else. Matching ignores case and takes time proportional to the
+// pattern's segments times the path's, never exponential.
+class ExcludeRules {
+public:
+    void Compile(const std::vector<std::string>& patterns);
+    // root is the crawl root fullPath lies below.
+    bool Matches(std::string_view name, std::string_view fullPath, std::string_view root) const;
+    bool Empty() const { return names.empty() && nameGlobs.empty() && pathGlobs.empty(); }
+
+private:
+    enum class Anchor {
+        Floating,
+        Root,
+        Absolute
+    };
+
+    struct PathGlob {
+        Anchor anchor;
+        std::vector<std::string> segments;
+    };
+
+    std::unordered_set<std::string> names;
+    std::vector<std::string> nameGlobs;
+    std::vector<PathGlob> pathGlobs;
+    bool hasRootGlobs = false;
+};
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& filePath);
+    void Close();
+
+    const unsigned char* Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* hFile = nullptr;
+    void* hMapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+// Moves tempPath over filePath in one step, replacing an existing file,
+// and removes tempPath if that fails. Readers see either the old file or
+// the new one, never a partly written one.
+bool ReplaceFileWith(const std::string& tempPath, const std::string& filePath);
+
+// Half-open range of index ids.
+struct IdRange {
+    uint32_t begin;
+    uint32_t end;
+};
+
+// Paths are kept sorted and front-coded in blocks of blockSize: the first
+// path of a block is stored whole, every later one as the length it shares
+// with its predecessor plus the remaining suffix. Ids are positions in the
+// sorted order. Lowercase text and basename offsets are produced while
+// decoding instead of being stored. Neighbouring paths share most of their
+// characters, so the search tables work per block: one CharMask per block
+// lets a scan skip the whole block undecoded, and trigram postings list
+// block numbers, which keeps them a fraction of the size of per-path lists.
+class FolderIndex {
+public:
+    static const uint32_t snapshotVersion = 6;
+    static const size_t blockSize = 16;
+
+    // Walks the index one path at a time. Seeking to the next id, or to a
+    // later id in the same block, continues from the current position, so a
+    // full scan or a sorted candidate list decodes every block only once.
+    class Decoder {
+    public:
+        explicit Decoder(const FolderIndex& index) : index(index) {}
+
+        void Seek(size_t id);
+        std::string_view Path() const { return path; }
+        std::string_view LowerPath() const { return lowerPath; }
+        size_t BasenameOffset() const { return basename; }
+
+    private:
+        void DecodeNext();
+
+        const FolderIndex& index;
+        size_t next = 0;
+        const uint8_t* cursor = nullptr;
+        const uint8_t* blockEnd = nullptr;
+        std::string path;
+        std::string lowerPath;
+        size_t basename = 0;
+    };
+
+    FolderIndex() = default;
+    FolderIndex(FolderIndex&&) = default;
+    FolderIndex& operator=(FolderIndex&&) = default;
+    FolderIndex(const FolderIndex&) = delete;
+    FolderIndex& operator=(const FolderIndex&) = delete;
+
+    void Build(const std::vector<std::string>& paths);
+    // Builds the paths of base without the ids in removed and with added,
+    // in one pass over base's blocks. Added paths already in base are kept
+    // once. base must be another index.
+    void BuildReplaced(const FolderIndex& base, std::vector<IdRange> removed, std::vector<std::string> added);
+    bool Save(const std::string& filePath) const;
+    bool Load(const std::string& filePath);
+    void Clear();
+
+    size_t Size() const { return count; }
+    bool Empty() const { return count == 0; }
+    std::string Path(size_t i) const;
+    // Union of the CharMasks of every path in block.
+    uint64_t BlockCharMask(size_t block) const { return charMasks[block]; }
+    size_t ByteSize() const;
+
+    bool TrigramCandidates(std::string_view lowerPattern, std::vector<uint32_t>& candidates) const;
+
+    // Paths are sorted byte-wise, so every path starting with prefix lies
+    // in one contiguous range of ids.
+    IdRange PrefixRange(std::string_view prefix) const;
+
+private:
+    // Appends a path that sorts after previous, the path appended before.
+    // Fails once the blocks outgrow 32-bit offsets.
+    bool AppendPath(std::string_view path, std::string_view previous);
+    void FinishBuild();
+    void BuildSearchTables();
+    size_t LowerBound(std::string_view key) const;
+
+    const uint64_t* charMasks = nullptr;
+    const uint32_t* blockOffsets = nullptr;
+    const uint8_t* blocks = nullptr;
+    size_t count = 0;
+
+    const uint32_t* trigramKeys = nullptr;
+    const uint32_t* postingOffsets = nullptr;
+    const uint8_t* postings = nullptr;
+    size_t trigramCount = 0;
+
+    std::vector<uint64_t> ownedCharMasks;
+    std::vector<uint32_t> ownedBlockOffsets;
+    std::vector<uint8_t> ownedBlocks;
+    std::vector<uint32_t> ownedTrigramKeys;
+    std::vector<uint32_t> ownedPostingOffsets;
+    std::vector<uint8_t> ownedPostings;
+    std::unique_ptr<MappedFile> mapping;
+};
+
+// Every save goes to a file of its own, <directory>/<stem>.<generation>.idx,
+// because on Windows a snapshot that a reader still has mapped can neither
+// be replaced nor truncated. Once a new generation is in place the older
+// files are deleted; one that is still mapped stays until its last mapping
+// is closed, and anything left over is swept again by the next save. A
+// <stem>.idx from before generations were numbered counts as generation 0.
+class SnapshotFiles {
+public:
+    SnapshotFiles(std::string directory, std::string stem) : directory(std::move(directory)), stem(std::move(stem)) {}
+
+    // Maps the newest snapshot that passes validation.
+    bool LoadNewest(FolderIndex& index);
+    bool Save(const FolderIndex& index);
+
+    std::string PathFor(uint64_t generation) const;
+
+private:
+    std::vector<uint64_t> Generations() const;
+    void RemoveOlder(uint64_t current) const;
+
+    std::string directory;
+    std::string stem;
+    uint64_t generation = 0;
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct HistoryEntry {
+    std::string path;
+    uint32_t launchCount = 0;
+    int64_t lastLaunch = 0;
+    double frecency = 0.0;
+};
+
+// Every launch gets the next journal sequence number, which is saved with
+// the history, so the history file says which journal records it already
+// holds.
+class FrecencyStore {
+public:
+    void Clear();
+    // Returns the launch's sequence number for the journal.
+    uint64_t Record(const std::string& path, int64_t now);
+    double Score(const HistoryEntry& entry, int64_t now) const;
+
+    const std::vector<HistoryEntry>& Entries() const { return entries; }
+    uint64_t Sequence() const { return sequence; }
+
+    bool Load(const std::string& filePath, int64_t now);
+    bool Save(const std::string& filePath) const;
+
+    // Applies the launches recorded in a journal and returns how many were
+    // new. Records up to the loaded Sequence() are already part of the
+    // history, so replaying a journal twice changes nothing, and two
+    // launches in the same second both count. Journals from before
+    // sequence numbers fall back to skipping launches no later than the
+    // path's lastLaunch.
+    size_t Replay(const std::string& journalPath);
+
+private:
+    HistoryEntry& Upsert(const std::string& path);
+
+    std::vector<HistoryEntry> entries;
+    std::unordered_map<std::string, size_t> lookup;
+    uint64_t sequence = 0;
+};
+
+// Writes history on a background thread. Launches are appended to the
+// journal as "sequence\ttime\tpath" lines; a compaction saves a copy of the
+// store next to the history file, replaces the old one with it, then
+// empties the journal. A crash between any two of those steps leaves a
+// history and a journal whose replay gives the same store. Requests run in
+// the order they were queued.
+class HistoryJournal {
+public:
+    ~HistoryJournal() { Stop(); }
+
+    void Start();
+    void Stop();
+
+    void Append(const std::string& journalPath, uint64_t sequence, const std::string& path, int64_t time);
+    void Compact(const std::string& historyPath, const std::string& journalPath, const FrecencyStore& store);
+
+private:
+    struct Task {
+        std::string journalPath;
+        std::string historyPath;
+        std::string line;
+        std::shared_ptr<const FrecencyStore> store;
+    };
+
+    void Run();
+    void Push(Task task);
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<Task> tasks;
+    bool isStopping = false;
+    std::thread worker;
+};
+
+// History is small, so the snapshot keeps plain strings in frecency order
+// rather than a front-coded FolderIndex.
+struct HistorySnapshot {
+    std::vector<std::string> paths;
+    std::vector<std::string> lowerPaths;
+    std::vector<size_t> basenames;
+    std::vector<int> rankBonus;
+    std::unordered_map<std::string_view, uint32_t> lookup;
+
+    bool Contains(std::string_view path) const { return lookup.find(path) != lookup.end(); }
+};
+
+std::shared_ptr<const HistorySnapshot> BuildHistorySnapshot(const FrecencyStore& store, int64_t now);
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// 32-bit pixels laid out as 0xAARRGGBB, which is BGRA in memory on
+// little-endian machines: the layout of both GDI+ 32bppARGB and 32-bit
+// GDI DIB sections.
+struct PixelBuffer {
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> pixels;
+
+    bool Empty() const { return pixels.empty(); }
+};
+
+// Resamples straight-alpha source pixels to width x height with an area
+// filter, multiplies every pixel by opacity and writes premultiplied
+// pixels, ready for AlphaBlend with AC_SRC_ALPHA. Filtering happens in
+// premultiplied space so transparent pixels never bleed colour into edges.
+void ScaleAndFade(const PixelBuffer& source, int width, int height, float opacity, PixelBuffer& target);
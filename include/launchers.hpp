@@ -1,23 +1,65 @@
 #pragma once
 
-enum class LauncherMode {
-    VSCode,
-    WSL
+#include "history.hpp"
+#include "imagekernel.hpp"
+
+// One argument of a launch command. The value may contain {path},
+// {wslPath} and {distro}; when it expands to nothing, the argument and its
+// flag are both left out.
+struct LaunchArgument {
+    std::string flag;
+    std::string value;
+};
+
+// Everything that sets one launcher apart, as data read from the config's
+// "launchers" list. Engine candidates are tried in order: paths have
+// %VARIABLES% expanded, bare file names are looked up on PATH. Folder
+// prefixes select the part of the shared crawl index the mode offers; no
+// include prefixes means all of it. The logo is a resource number or an
+// image file path.
+struct LauncherModeSpec {
+    std::string name;
+    std::string historyName;
+    std::string logo;
+    std::string placeholder;
+    std::vector<std::string> engineCandidates;
+    std::vector<std::string> includePrefixes;
+    std::vector<std::string> excludePrefixes;
+    std::vector<LaunchArgument> command;
+    std::vector<std::pair<std::string, std::string>> environment;
+};
+
+// The popup of one mode. It is built once, only hidden between uses, and
+// rebuilt after a DPI or display change.
+struct LauncherWindow {
+    HWND hWindow = NULL;
+    HWND hEdit = NULL;
+    HWND hResultList = NULL;
+    HWND hPathLabel = NULL;
+    int screenWidth = 0;
+    int screenHeight = 0;
+    int rowHeight = 1;
+    bool isStale = false;
 };
 
 struct LauncherContext {
-    LauncherMode type;
+    LauncherModeSpec spec;
     std::string windowTitle;
-    int logoResourceID;
     std::string historyFileName;
+    std::string journalFileName;
+    size_t journalEvents = 0;
     bool isEngineFound = false;
     std::string executablePath;
-    std::string cliPath;
-    Gdiplus::Image* logoImage = nullptr;
-    std::string placeholder;
-    std::vector<std::string> history;
+    PixelBuffer logo;
+    HBITMAP fadedLogo = NULL;
+    int fadedLogoWidth = 0;
+    int fadedLogoHeight = 0;
+    FrecencyStore history;
+    std::shared_ptr<const HistorySnapshot> historySnapshot;
+    LauncherWindow window;
 };
 
 void InitializeLauncher();
-void ShowLauncher(LauncherMode mode);
+// name is a Config::launchers entry loaded at startup.
+void ShowLauncher(const std::string& name);
 void ReleaseLauncherResources();
\ No newline at end of file
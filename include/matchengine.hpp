@@ -0,0 +1,35 @@
+#pragma once
+
+#include "folderindex.hpp"
+#include "matcher.hpp"
+
+#include <functional>
+#include <string_view>
+#include <vector>
+
+struct IndexMatchOptions {
+    std::string_view lowerPattern;
+    bool exact = false;
+    size_t limit = 0;
+    unsigned int threadCount = 0;
+    // Matching paths still count as survivors but never enter the top list.
+    std::function<bool(std::string_view path)> isExcluded;
+    std::function<bool()> isCancelled;
+};
+
+struct IndexMatchResult {
+    std::vector<ScoredMatch> best;
+    std::vector<uint32_t> survivors;
+    size_t visited = 0;
+    bool cancelled = false;
+};
+
+// Scores every id of view, or only the candidates inside view when a
+// sorted candidate list is given. Paths in a block whose CharMask rules
+// them out are skipped without being decoded. The work is cut into chunks
+// that the threads claim in turn. The threads besides the caller come from
+// a pool started on first use; each keeps its own bounded heap and
+// decoder, and the heaps are merged once all chunks are done. Survivors
+// come back in ascending id order, ready for a CandidateCache.
+void MatchIndex(const FolderIndex& index, const std::vector<IdRange>& view, const std::vector<uint32_t>* candidates,
+                const IndexMatchOptions& options, IndexMatchResult& result);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct ScoredMatch {
+    int score;
+    uint32_t id;
+    uint32_t length;
+};
+
+class TopMatches {
+public:
+    explicit TopMatches(size_t limit) : limit(limit) {}
+
+    void Offer(int score, uint32_t id, uint32_t length);
+    void Merge(const TopMatches& other);
+    std::vector<ScoredMatch> Sorted() const;
+
+private:
+    size_t limit;
+    std::vector<ScoredMatch> heap;
+};
+
+class CandidateCache {
+public:
+    const std::vector<uint32_t>* Narrow(std::string_view lowerPattern);
+    void Store(std::string_view lowerPattern, std::vector<uint32_t> survivors);
+    void Clear() { levels.clear(); }
+
+private:
+    struct Level {
+        std::string pattern;
+        std::vector<uint32_t> survivors;
+    };
+    std::vector<Level> levels;
+};
+
+std::string LowerPattern(std::string_view pattern);
+
+// One bit per letter and digit, the rest of the bytes share the remaining
+// 28 bits. A path can only match when its mask covers the pattern's.
+uint64_t CharMask(std::string_view lowerText);
+inline bool CouldMatch(uint64_t patternMask, uint64_t textMask) { return (patternMask & ~textMask) == 0; }
+
+bool ExactMatch(std::string_view lowerPattern, std::string_view text, std::string_view lowerText,
+                size_t basenameOffset, int& score);
+bool FuzzyMatch(std::string_view lowerPattern, std::string_view text, std::string_view lowerText,
+                size_t basenameOffset, int& score);
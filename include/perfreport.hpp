@@ -0,0 +1,72 @@
+#pragma once
+
+#include "crawler.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct CrawlPerf {
+    uint64_t wallMs = 0;
+    uint64_t buildMs = 0;
+    size_t directories = 0;
+    double directoriesPerSecond = 0.0;
+    size_t indexBytes = 0;
+    std::vector<CrawlRootStats> roots;
+};
+
+struct MatchPerf {
+    uint64_t queries = 0;
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+    double lastMs = 0.0;
+    size_t lastCandidates = 0;
+    size_t lastIndexSize = 0;
+
+    void Record(double elapsedMs, size_t candidates, size_t indexSize);
+};
+
+// Launch time runs from Enter to the launched program's window reaching the
+// foreground. Launches whose window never showed up count as timeouts.
+struct LaunchPerf {
+    uint64_t launches = 0;
+    uint64_t timeouts = 0;
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+    double lastMs = 0.0;
+
+    void Record(double elapsedMs);
+};
+
+// Show time runs from the launcher hotkey to the end of the result list's
+// first paint. Shows that had to rebuild the window are counted apart, since
+// only those pay for creating controls and fonts.
+struct ShowPerf {
+    static constexpr double budgetMs = 16.0;
+
+    uint64_t shows = 0;
+    uint64_t rebuilds = 0;
+    uint64_t overBudget = 0;
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+    double lastMs = 0.0;
+
+    void Record(double elapsedMs, bool isRebuilt);
+};
+
+struct StageTiming {
+    std::string name;
+    double startMs = 0.0;
+    double durationMs = 0.0;
+};
+
+// Peak resident memory of this process in bytes, or 0 if unavailable.
+size_t PeakMemoryBytes();
+
+// Writes one JSON document per crawl, with stable key order so reports
+// from two builds can be diffed line by line.
+bool SavePerfReport(const std::string& filePath, const CrawlPerf& crawl, const MatchPerf& match,
+                    const LaunchPerf& launch, const ShowPerf& show);
+
+bool SaveStartupReport(const std::string& filePath, const std::vector<StageTiming>& stages);
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Environment entries are applied on top of the launcher's own environment.
+// An entry with an empty value removes that variable from the child.
+struct SpawnRequest {
+    std::string executable;
+    std::vector<std::string> arguments;
+    std::vector<std::pair<std::string, std::string>> environment;
+    bool hidden = false;
+};
+
+// Quotes one argument so that CommandLineToArgvW and the MSVC runtime hand
+// it back unchanged, including embedded quotes and trailing backslashes.
+std::string QuoteWindowsArgument(const std::string& argument);
+std::string JoinWindowsArguments(const std::vector<std::string>& arguments);
+std::string BuildWindowsCommandLine(const SpawnRequest& request);
+
+// Returns current with every override applied, as NAME=value strings.
+// Windows variable names compare case-insensitively.
+std::vector<std::string> MergeEnvironment(const std::vector<std::string>& current,
+                                          const std::vector<std::pair<std::string, std::string>>& overrides,
+                                          bool ignoreCase);
+
+class ProcessSpawner {
+public:
+    virtual ~ProcessSpawner() = default;
+
+    // Starts the process without waiting for it. Returns its process id,
+    // or 0 if it could not be started.
+    virtual uint32_t Spawn(const SpawnRequest& request) = 0;
+};
+
+// On Windows an elevated launcher parents the child to Explorer, so editors
+// and shells never inherit the administrator token.
+std::unique_ptr<ProcessSpawner> CreateProcessSpawner();
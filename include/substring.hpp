@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+// Same result as text.find(pattern, from). On x86 the search compares the
+// first and last pattern byte against 16 or 32 positions at once and only
+// verifies the positions where both agree; the widest kernel the CPU
+// supports is picked once at startup.
+size_t FindSubstring(std::string_view text, std::string_view pattern, size_t from = 0);
+
+// "avx2", "sse2" or "scalar", for perf reports.
+const char* SubstringKernelName();
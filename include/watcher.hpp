@@ -0,0 +1,49 @@
+#pragma once
+
+#include "excludes.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum class FolderChange {
+    Added,
+    Removed,
+    Overflow
+};
+
+// Overflow means changes under path were dropped and only a rescan can
+// recover them.
+struct FolderEvent {
+    FolderChange change;
+    std::string path;
+};
+
+using FolderEventCallback = std::function<void(const std::vector<FolderEvent>& events)>;
+
+// Watches folder creation, deletion and renames below a set of roots.
+// Events under excluded folders are dropped. The rest are collected on a
+// background thread and delivered once no new event has arrived for
+// settleMs, or after maxDelayMs at the latest. Start fails only when no
+// root at all could be watched.
+class DirectoryWatcher {
+public:
+    virtual ~DirectoryWatcher() = default;
+
+    virtual bool Start(const std::vector<std::string>& roots, const ExcludeRules& excludes,
+                       FolderEventCallback onEvents) = 0;
+    virtual void Stop() = 0;
+
+    // Roots the last Start could not watch or that never report changes,
+    // such as a missing folder or a WSL share. They have to be polled.
+    const std::vector<std::string>& UnwatchedRoots() const { return unwatchedRoots; }
+
+    unsigned int settleMs = 250;
+    unsigned int maxDelayMs = 1000;
+
+protected:
+    std::vector<std::string> unwatchedRoots;
+};
+
+std::unique_ptr<DirectoryWatcher> CreateDirectoryWatcher();
@@ -7,12 +7,56 @@ namespace Config {
     bool enableTabSwitcher;
     std::set<std::string> tabbedApps;
 
+    std::vector<LauncherSettings> launchers;
+
+    // Configs from before the "launchers" list switch and rebind the two
+    // built-in launchers with these keys instead.
     bool enableVSCodeLauncher;
     unsigned int VSCodeLauncherKey;
 
     bool enableWSLTerminalLauncher;
     unsigned int WSLTerminalLauncherKey;
 
+    bool projectRootCrawl = true;
+    int projectSubFolderDepth = 0;
+    std::vector<std::string> crawlerRoots;
+    std::vector<std::string> crawlerExcludes;
+
+    const std::vector<std::string> defaultCrawlerExcludes = {
+        "node_modules", ".git", "bin", ".vs", "obj", ".venv", "target", "dist", ".cache"
+    };
+
+    std::vector<LauncherSettings> DefaultLaunchers() {
+        LauncherSettings vsCode;
+        vsCode.name = "VS Code";
+        vsCode.enabled = enableVSCodeLauncher;
+        vsCode.key = VSCodeLauncherKey;
+        vsCode.history = "vscodelauncher_history";
+        vsCode.logo = "101";
+        vsCode.placeholder = "Search for VS Code projects...";
+        vsCode.engine = {
+            "%LOCALAPPDATA%\\Programs\\Microsoft VS Code\\Code.exe",
+            "%ProgramFiles%\\Microsoft VS Code\\Code.exe",
+            "C:\\Program Files\\Microsoft VS Code\\Code.exe"
+        };
+        // Code.exe handles folder arguments itself; these are the variables
+        // the cli.js wrapper would otherwise have fixed up before starting it.
+        vsCode.command = { "{path}" };
+        vsCode.environment = { "ELECTRON_RUN_AS_NODE=", "ELECTRON_NO_ATTACH_CONSOLE=1" };
+
+        LauncherSettings wsl;
+        wsl.name = "WSL";
+        wsl.enabled = enableWSLTerminalLauncher;
+        wsl.key = WSLTerminalLauncherKey;
+        wsl.history = "wsllauncher_history";
+        wsl.logo = "102";
+        wsl.placeholder = "Search for WSL directories...";
+        wsl.engine = { "wsl.exe" };
+        wsl.command = { "-d {distro}", "--cd {wslPath}" };
+
+        return { vsCode, wsl };
+    }
+
     bool enableTaskSwitcher;
     unsigned int allAppsSwitcherMod;
     unsigned int allAppsSwitcherKey;
@@ -34,6 +78,13 @@ namespace Config {
         enableWSLTerminalLauncher = true;
         WSLTerminalLauncherKey = 'L';
 
+        launchers = DefaultLaunchers();
+
+        projectRootCrawl = true;
+        projectSubFolderDepth = 0;
+        crawlerRoots.clear();
+        crawlerExcludes = defaultCrawlerExcludes;
+
         enableTaskSwitcher = true;
         allAppsSwitcherMod = VK_MENU;
         allAppsSwitcherKey = VK_TAB;
@@ -53,6 +104,49 @@ namespace Config {
         return "config.jsonc";
     }
 
+    std::string VKToString(unsigned int vk) {
+        if (vk == VK_MENU)    return "ALT";
+        if (vk == VK_CONTROL) return "CTRL";
+        if (vk == VK_SHIFT)   return "SHIFT";
+        if (vk == VK_TAB)     return "TAB";
+        if (vk == VK_SPACE)   return "SPACE";
+        if (vk == 192)        return "TILDE";
+
+        return std::string(1, (char)vk);
+    }
+
+    std::string Quote(const std::string& s) {
+        std::string quoted = "\"";
+        for (char c : s) {
+            if (c == '\\' || c == '"') quoted += '\\';
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+
+    std::string QuoteArray(const std::vector<std::string>& items) {
+        std::string quoted = "[";
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (i > 0) quoted += ", ";
+            quoted += Quote(items[i]);
+        }
+        return quoted + "]";
+    }
+
+    void WriteLauncher(std::ofstream& file, const LauncherSettings& launcher) {
+        file << "    { \"name\": " << Quote(launcher.name)
+             << ", \"enabled\": " << (launcher.enabled ? "true" : "false")
+             << ", \"key\": " << Quote(VKToString(launcher.key))
+             << ", \"history\": " << Quote(launcher.history)
+             << ", \"logo\": " << Quote(launcher.logo)
+             << ", \"placeholder\": " << Quote(launcher.placeholder)
+             << ", \"engine\": " << QuoteArray(launcher.engine)
+             << ", \"include\": " << QuoteArray(launcher.include)
+             << ", \"exclude\": " << QuoteArray(launcher.exclude)
+             << ", \"command\": " << QuoteArray(launcher.command)
+             << ", \"environment\": " << QuoteArray(launcher.environment) << " }";
+    }
+
     void SaveDefaultConfig(const std::string& fullPath) {
         std::ofstream file(fullPath);
         if (!file.is_open()) return;
@@ -71,13 +165,29 @@ namespace Config {
         }        
         file << "],\n\n";
         
-        file << "  // Enable or disable VS Code launcher and shortcuts (Mandatory: Ctrl + Alt + Key)\n"
-             << "  \"enableVSCodeLauncher\": true,\n"
-             << "  \"VSCodeLauncherKey\": \"V\",\n\n";
-        
-        file << "  // Enable or disable WSL terminal launcher and shortcuts (Mandatory: Ctrl + Alt + Key)\n"
-             << "  \"enableWSLTerminalLauncher\": true,\n"
-             << "  \"WSLTerminalLauncherKey\": \"L\",\n\n";
+        file << "  // Launchers, one per line, opened with Ctrl + Alt + key. The engine is the first path or PATH name found;\n"
+             << "  // include/exclude narrow the shared folder index by path prefix; command items are arguments taking\n"
+             << "  // {path}, {wslPath} and {distro}. Adding or renaming a launcher takes effect after a restart\n"
+             << "  \"launchers\": [\n";
+        for (size_t j = 0; j < launchers.size(); ++j) {
+            WriteLauncher(file, launchers[j]);
+            file << (j + 1 < launchers.size() ? ",\n" : "\n");
+        }
+        file << "  ],\n\n";
+
+        file << "  // Index folders containing .git, package.json, CMakeLists.txt, *.sln, Cargo.toml or pyproject.toml\n"
+             << "  // as single projects, adding only this many levels of their subfolders\n"
+             << "  \"projectRootCrawl\": true,\n"
+             << "  \"projectSubFolderDepth\": 0,\n\n";
+
+        file << "  // Extra folders to index, and gitignore-style folder excludes (\"target\", \"**/.venv\", \"build-*\", \"/mnt/c/**\")\n"
+             << "  \"crawlerRoots\": [],\n"
+             << "  \"crawlerExcludes\": [";
+        for (size_t j = 0; j < crawlerExcludes.size(); ++j) {
+            file << "\"" << crawlerExcludes[j] << "\"";
+            if (j + 1 < crawlerExcludes.size()) file << ", ";
+        }
+        file << "],\n\n";
             
         file << "  // Enable or disable Task Switcher\n"
              << "  \"enableTaskSwitcher\": true,\n\n";
@@ -134,6 +244,8 @@ namespace Config {
         else if (key == "enableVSCodeLauncher")      enableVSCodeLauncher      = (cleanValue == "true");
         else if (key == "enableWSLTerminalLauncher") enableWSLTerminalLauncher = (cleanValue == "true");
         else if (key == "enableTaskSwitcher")        enableTaskSwitcher        = (cleanValue == "true");
+        else if (key == "projectRootCrawl")          projectRootCrawl          = (cleanValue == "true");
+        else if (key == "projectSubFolderDepth")     projectSubFolderDepth     = std::max<int>(0, std::atoi(cleanValue.c_str()));
         
         else if (key == "VSCodeLauncherKey")      VSCodeLauncherKey      = StringToVK(cleanValue);
         else if (key == "WSLTerminalLauncherKey") WSLTerminalLauncherKey = StringToVK(cleanValue);
@@ -160,6 +272,93 @@ namespace Config {
         }
     }
 
+    // Unlike CleanValue this keeps spaces inside the quotes, which paths need,
+    // and undoes JSON escapes such as "C:\\Projects". pos is on the opening
+    // quote and is left just past the closing one.
+    std::string ReadQuoted(const std::string& val, size_t& pos) {
+        std::string item;
+        size_t i = pos + 1;
+        for (; i < val.size() && val[i] != '"'; ++i) {
+            if (val[i] == '\\' && i + 1 < val.size()) ++i;
+            item += val[i];
+        }
+        pos = i + 1;
+        return item;
+    }
+
+    // pos is on the '[' and is left just past the ']'.
+    std::vector<std::string> ReadStringArray(const std::string& val, size_t& pos) {
+        std::vector<std::string> items;
+        while (true) {
+            pos = val.find_first_of("\"]", pos + 1);
+            if (pos == std::string::npos) return items;
+            if (val[pos] == ']') break;
+            std::string item = ReadQuoted(val, pos);
+            if (!item.empty()) items.push_back(item);
+            --pos;
+        }
+        ++pos;
+        return items;
+    }
+
+    std::vector<std::string> ParseStringArray(const std::string& val) {
+        size_t pos = val.find("[");
+        if (pos == std::string::npos) return {};
+        return ReadStringArray(val, pos);
+    }
+
+    // A launcher is one object on one line, its fields in any order.
+    bool ParseLauncher(const std::string& line, LauncherSettings& launcher) {
+        size_t pos = line.find('{');
+        while (pos != std::string::npos) {
+            pos = line.find_first_of("\"}", pos);
+            if (pos == std::string::npos || line[pos] == '}') break;
+            std::string field = ReadQuoted(line, pos);
+            pos = line.find(':', pos);
+            if (pos == std::string::npos) break;
+            pos = line.find_first_not_of(" \t", pos + 1);
+            if (pos == std::string::npos) break;
+
+            if (line[pos] == '[') {
+                std::vector<std::string> items = ReadStringArray(line, pos);
+                if      (field == "engine")      launcher.engine      = items;
+                else if (field == "include")     launcher.include     = items;
+                else if (field == "exclude")     launcher.exclude     = items;
+                else if (field == "command")     launcher.command     = items;
+                else if (field == "environment") launcher.environment = items;
+            } else if (line[pos] == '"') {
+                std::string value = ReadQuoted(line, pos);
+                if      (field == "name")        launcher.name        = value;
+                else if (field == "history")     launcher.history     = value;
+                else if (field == "logo")        launcher.logo        = value;
+                else if (field == "placeholder") launcher.placeholder = value;
+                else if (field == "key" && !value.empty()) launcher.key = StringToVK(value);
+            } else {
+                size_t end = line.find_first_of(",}", pos);
+                std::string value = CleanValue(line.substr(pos, end == std::string::npos ? std::string::npos : end - pos));
+                if (field == "enabled") launcher.enabled = (value == "true");
+                pos = end;
+            }
+        }
+        if (launcher.history.empty()) launcher.history = launcher.name;
+        return !launcher.name.empty() && launcher.key != 0;
+    }
+
+    // The list ends at the first line outside an object holding a ']'.
+    void ParseLaunchers(std::ifstream& file, std::string line) {
+        launchers.clear();
+        do {
+            line.erase(0, line.find_first_not_of(" \t["));
+            if (line.find("//") == 0) continue;
+            if (line.find('{') == 0) {
+                LauncherSettings launcher;
+                if (ParseLauncher(line, launcher)) launchers.push_back(launcher);
+            } else if (line.find(']') != std::string::npos) {
+                return;
+            }
+        } while (std::getline(file, line));
+    }
+
     void LoadConfig() {
         std::string configPath = GetConfigPath();
         std::ifstream file(configPath);
@@ -170,6 +369,12 @@ namespace Config {
         }
 
         tabbedApps.clear();
+        crawlerRoots.clear();
+        crawlerExcludes = defaultCrawlerExcludes;
+        enableVSCodeLauncher = enableWSLTerminalLauncher = true;
+        VSCodeLauncherKey = 'V';
+        WSLTerminalLauncherKey = 'L';
+        bool hasLaunchers = false;
 
         std::string line;
         while (std::getline(file, line)) {
@@ -184,11 +389,19 @@ namespace Config {
 
             if (key == "tabbedApps") {
                 ParseTabbedApps(val);
+            } else if (key == "crawlerRoots") {
+                crawlerRoots = ParseStringArray(val);
+            } else if (key == "crawlerExcludes") {
+                crawlerExcludes = ParseStringArray(val);
+            } else if (key == "launchers") {
+                ParseLaunchers(file, val);
+                hasLaunchers = true;
             } else {
                 AssignSetting(key, val);
             }
 
         }
+        if (!hasLaunchers) launchers = DefaultLaunchers();
         return;
     }
 }
\ No newline at end of file
@@ -0,0 +1,527 @@
+#include "crawler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+bool IsProjectMarker(const char* name) {
+    static const char* const markers[] = {
+        ".git", "package.json", "CMakeLists.txt", "Cargo.toml", "pyproject.toml"
+    };
+    for (const char* marker : markers) {
+        if (strcmp(name, marker) == 0) return true;
+    }
+    size_t length = strlen(name);
+    return length > 4 && strcmp(name + length - 4, ".sln") == 0;
+}
+
+#ifdef _WIN32
+// Hidden, system and offline folders are never indexed, and reparse points
+// are not followed.
+static bool IsListedAttributes(DWORD attributes) {
+    return (attributes & FILE_ATTRIBUTE_DIRECTORY) &&
+           !(attributes & (FILE_ATTRIBUTE_REPARSE_POINT | FILE_ATTRIBUTE_HIDDEN | FILE_ATTRIBUTE_SYSTEM |
+                           FILE_ATTRIBUTE_OFFLINE));
+}
+
+class Win32FileSystem : public CrawlFileSystem {
+public:
+    char Separator() const override { return '\\'; }
+
+    bool GetLastWriteTime(const std::string& path, uint64_t& lastWriteTime) override {
+        WIN32_FILE_ATTRIBUTE_DATA attrData;
+        if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &attrData)) return false;
+        lastWriteTime = ((uint64_t)attrData.ftLastWriteTime.dwHighDateTime << 32) | attrData.ftLastWriteTime.dwLowDateTime;
+        return true;
+    }
+
+    void ListDirectory(const std::string& path, CrawlListing& listing) override {
+        WIN32_FIND_DATAA fd;
+        HANDLE hFind = FindFirstFileExA((path + "\\*").c_str(), FindExInfoBasic, &fd,
+                                        FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+        if (hFind == INVALID_HANDLE_VALUE) return;
+        do {
+            if (!listing.isProject && IsProjectMarker(fd.cFileName)) listing.isProject = true;
+            if (!IsListedAttributes(fd.dwFileAttributes)) continue;
+            if (strcmp(fd.cFileName, ".") == 0 || strcmp(fd.cFileName, "..") == 0) {
+                continue;
+            }
+            listing.subdirectories.push_back(fd.cFileName);
+        } while (FindNextFileA(hFind, &fd));
+        FindClose(hFind);
+    }
+
+    bool IsListedFolder(const std::string& path) override {
+        DWORD attributes = GetFileAttributesA(path.c_str());
+        return attributes != INVALID_FILE_ATTRIBUTES && IsListedAttributes(attributes);
+    }
+};
+
+CrawlFileSystem& NativeFileSystem() {
+    static Win32FileSystem fileSystem;
+    return fileSystem;
+}
+#else
+class PosixFileSystem : public CrawlFileSystem {
+public:
+    char Separator() const override { return '/'; }
+
+    bool GetLastWriteTime(const std::string& path, uint64_t& lastWriteTime) override {
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) return false;
+        lastWriteTime = (uint64_t)st.st_mtim.tv_sec * 1000000000ull + (uint64_t)st.st_mtim.tv_nsec;
+        return true;
+    }
+
+    void ListDirectory(const std::string& path, CrawlListing& listing) override {
+        DIR* dir = opendir(path.c_str());
+        if (!dir) return;
+        while (dirent* entry = readdir(dir)) {
+            if (!listing.isProject && IsProjectMarker(entry->d_name)) listing.isProject = true;
+            if (entry->d_name[0] == '.') continue;
+            bool isDirectory = entry->d_type == DT_DIR;
+            if (entry->d_type == DT_UNKNOWN) {
+                struct stat st;
+                std::string fullPath = path + "/" + entry->d_name;
+                isDirectory = lstat(fullPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+            }
+            if (isDirectory) listing.subdirectories.push_back(entry->d_name);
+        }
+        closedir(dir);
+    }
+
+    bool IsListedFolder(const std::string& path) override {
+        size_t slash = path.find_last_of('/');
+        const char* name = path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+        struct stat st;
+        return name[0] != '.' && lstat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+    }
+};
+
+CrawlFileSystem& NativeFileSystem() {
+    static PosixFileSystem fileSystem;
+    return fileSystem;
+}
+#endif
+
+uint32_t CrawlDirTree::FindChild(uint32_t dir, const char* name) const {
+    const Child* begin = children.data() + dirs[dir].firstChild;
+    const Child* end = begin + dirs[dir].childCount;
+    const Child* found = std::lower_bound(begin, end, name, [this](const Child& child, const char* key) {
+        return strcmp(Name(child), key) < 0;
+    });
+    return found != end && strcmp(Name(*found), name) == 0 ? found->dir : none;
+}
+
+size_t CrawlDirTree::ByteSize() const {
+    return dirs.capacity() * sizeof(Dir) + children.capacity() * sizeof(Child) + names.capacity();
+}
+
+// projectLevel counts levels below the enclosing project folder, or is -1
+// outside of any project. previous is the directory's record in the last
+// crawl's tree, and the parent fields name the child entry that led here.
+struct CrawlTask {
+    std::string path;
+    int depth;
+    int projectLevel;
+    uint32_t previous;
+    uint32_t parentWorker;
+    uint32_t parentRecord;
+    uint32_t childIndex;
+};
+
+// What a worker learned about one directory. Children are a run of the
+// worker's child list; names from a fresh listing live in the worker's own
+// name buffer and are tagged with freshName, reused ones still point into
+// the previous tree. They are interned once the crawl is over.
+struct VisitedDir {
+    uint64_t lastWriteTime;
+    bool isProject;
+    uint32_t firstChild;
+    uint32_t childCount;
+    uint32_t parentWorker;
+    uint32_t parentRecord;
+    uint32_t childIndex;
+};
+
+struct VisitedChild {
+    uint32_t name;
+    uint32_t previous;
+};
+
+static const uint32_t freshName = 0x80000000;
+
+struct CrawlWorker {
+    std::mutex mutex;
+    std::deque<CrawlTask> tasks;
+    std::vector<std::string> results;
+    size_t flushed = 0;
+    std::vector<VisitedDir> visited;
+    std::vector<VisitedChild> children;
+    std::vector<char> names;
+};
+
+struct CrawlRun {
+    CrawlFileSystem& fs;
+    const std::string& root;
+    const CrawlDirTree& previous;
+    const CrawlOptions& options;
+    std::mutex& batchMutex;
+    int maxDepth;
+    std::chrono::steady_clock::time_point deadline;
+    std::vector<std::unique_ptr<CrawlWorker>> workers;
+    std::atomic<size_t> pending{0};
+    std::atomic<size_t> entries{0};
+    std::atomic<bool> timedOut{false};
+    std::atomic<bool> truncated{false};
+    std::atomic<bool> depthLimited{false};
+    std::atomic<bool> cancelled{false};
+};
+
+static std::string JoinPath(const std::string& parent, const char* child, char separator) {
+    if (!parent.empty() && parent.back() == separator) return parent + child;
+    return parent + separator + child;
+}
+
+static const char* ChildName(const CrawlDirTree& previous, const CrawlWorker& worker, const VisitedChild& child) {
+    if (child.name & freshName) return worker.names.data() + (child.name & ~freshName);
+    return previous.names.data() + child.name;
+}
+
+static void PushTask(CrawlRun& run, CrawlWorker& worker, CrawlTask task) {
+    run.pending.fetch_add(1);
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.tasks.push_back(std::move(task));
+}
+
+static bool PopTask(CrawlWorker& worker, CrawlTask& task) {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) return false;
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+static bool StealTask(CrawlRun& run, size_t self, CrawlTask& task) {
+    size_t workerCount = run.workers.size();
+    for (size_t i = 1; i < workerCount; ++i) {
+        CrawlWorker& victim = *run.workers[(self + i) % workerCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+static void FlushBatch(CrawlRun& run, CrawlWorker& worker) {
+    std::vector<std::string> batch(worker.results.begin() + worker.flushed, worker.results.end());
+    worker.flushed = worker.results.size();
+    std::lock_guard<std::mutex> lock(run.batchMutex);
+    run.options.onBatch(batch);
+}
+
+// Once a root runs past its time budget the remaining directories are
+// answered from the previous crawl's records without touching the file
+// system, so the root keeps its last good results instead of losing them.
+static void ProcessTask(CrawlRun& run, uint32_t self, const CrawlTask& task) {
+    if (!run.timedOut && std::chrono::steady_clock::now() > run.deadline) run.timedOut = true;
+
+    CrawlWorker& worker = *run.workers[self];
+    const CrawlDirTree& previous = run.previous;
+    const CrawlDirTree::Dir* cached = task.previous != CrawlDirTree::none ? &previous.dirs[task.previous] : nullptr;
+    VisitedDir record { 0, false, (uint32_t)worker.children.size(), 0, task.parentWorker, task.parentRecord, task.childIndex };
+    bool isCached = false;
+    if (run.timedOut) {
+        if (!cached) return;
+        isCached = true;
+    } else {
+        if (!run.fs.GetLastWriteTime(task.path, record.lastWriteTime)) return;
+        isCached = cached && cached->lastWriteTime == record.lastWriteTime;
+    }
+
+    if (isCached) {
+        record.lastWriteTime = cached->lastWriteTime;
+        record.isProject = cached->isProject;
+        for (uint32_t k = 0; k < cached->childCount; ++k) {
+            const CrawlDirTree::Child& child = previous.children[cached->firstChild + k];
+            worker.children.push_back({ child.name, child.dir });
+        }
+    } else {
+        CrawlListing listing;
+        run.fs.ListDirectory(task.path, listing);
+        record.isProject = listing.isProject;
+        for (const auto& name : listing.subdirectories) {
+            uint32_t previousDir = cached ? previous.FindChild(task.previous, name.c_str()) : CrawlDirTree::none;
+            worker.children.push_back({ (uint32_t)worker.names.size() | freshName, previousDir });
+            worker.names.insert(worker.names.end(), name.c_str(), name.c_str() + name.size() + 1);
+        }
+    }
+    record.childCount = (uint32_t)worker.children.size() - record.firstChild;
+    uint32_t recordIndex = (uint32_t)worker.visited.size();
+    worker.visited.push_back(record);
+
+    int projectLevel = task.projectLevel;
+    if (projectLevel < 0 && run.options.stopAtProjects && record.isProject) projectLevel = 0;
+    bool listChildren = projectLevel < 0 || projectLevel < run.options.projectDepth;
+    bool descend = projectLevel < 0 || projectLevel + 1 < run.options.projectDepth;
+    int childLevel = projectLevel < 0 ? -1 : projectLevel + 1;
+
+    if (listChildren) {
+        size_t added = 0;
+        for (uint32_t k = 0; k < record.childCount; ++k) {
+            const VisitedChild& child = worker.children[record.firstChild + k];
+            const char* name = ChildName(previous, worker, child);
+            std::string fullPath = JoinPath(task.path, name, run.fs.Separator());
+            if (run.options.excludes && run.options.excludes->Matches(name, fullPath, run.root)) continue;
+            worker.results.push_back(fullPath);
+            ++added;
+            if (task.depth < run.maxDepth && descend) {
+                PushTask(run, worker, { std::move(fullPath), task.depth + 1, childLevel, child.previous, self, recordIndex, k });
+            }
+        }
+        if (task.depth >= run.maxDepth && descend && added > 0) run.depthLimited = true;
+        if (run.entries.fetch_add(added) + added >= run.options.entryBudget) {
+            run.truncated = true;
+        }
+    }
+
+    if (run.options.onBatch && worker.results.size() - worker.flushed >= std::max<size_t>(run.options.batchSize, 1)) {
+        FlushBatch(run, worker);
+    }
+}
+
+static void RunWorker(CrawlRun& run, size_t self) {
+    CrawlWorker& worker = *run.workers[self];
+    CrawlTask task;
+    int idleRounds = 0;
+    while (true) {
+        if (!run.cancelled && run.options.isCancelled && run.options.isCancelled()) run.cancelled = true;
+        if (!run.truncated && !run.cancelled && (PopTask(worker, task) || StealTask(run, self, task))) {
+            ProcessTask(run, (uint32_t)self, task);
+            run.pending.fetch_sub(1);
+            idleRounds = 0;
+            continue;
+        }
+        if (run.pending.load() == 0 || run.truncated || run.cancelled) return;
+        if (++idleRounds < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+}
+
+// Copies one directory of the previous tree and everything recorded below
+// it, for subtrees a timed-out crawl never reached.
+template <typename Intern>
+static uint32_t CopySubtree(const CrawlDirTree& from, uint32_t dir, CrawlDirTree& to, Intern& intern) {
+    const CrawlDirTree::Dir& source = from.dirs[dir];
+    uint32_t copy = (uint32_t)to.dirs.size();
+    uint32_t firstChild = (uint32_t)to.children.size();
+    to.dirs.push_back({ source.lastWriteTime, firstChild, source.childCount, source.isProject });
+    for (uint32_t k = 0; k < source.childCount; ++k) {
+        to.children.push_back({ intern(from.Name(from.children[source.firstChild + k])), CrawlDirTree::none });
+    }
+    for (uint32_t k = 0; k < source.childCount; ++k) {
+        uint32_t child = from.children[source.firstChild + k].dir;
+        if (child != CrawlDirTree::none) {
+            uint32_t copied = CopySubtree(from, child, to, intern);
+            to.children[firstChild + k].dir = copied;
+        }
+    }
+    return copy;
+}
+
+// Record r of worker w becomes dir recordBase[w] + r, and its children keep
+// their place in the worker's child list, so linking a record to its
+// parent's child entry needs no lookup. Names are interned and every run
+// is sorted by name here, once, instead of on the workers.
+static void BuildDirTree(const CrawlRun& run, CrawlDirTree& tree) {
+    const CrawlDirTree& previous = run.previous;
+    size_t workerCount = run.workers.size();
+    std::vector<uint32_t> recordBase(workerCount + 1, 0);
+    std::vector<uint32_t> childBase(workerCount + 1, 0);
+    for (size_t w = 0; w < workerCount; ++w) {
+        recordBase[w + 1] = recordBase[w] + (uint32_t)run.workers[w]->visited.size();
+        childBase[w + 1] = childBase[w] + (uint32_t)run.workers[w]->children.size();
+    }
+
+    CrawlDirTree next;
+    next.dirs.resize(recordBase[workerCount]);
+    next.children.resize(childBase[workerCount]);
+    std::unordered_map<std::string_view, uint32_t> interned;
+    auto intern = [&](const char* name) {
+        auto found = interned.emplace(std::string_view(name), (uint32_t)next.names.size());
+        if (found.second) next.names.insert(next.names.end(), name, name + strlen(name) + 1);
+        return found.first->second;
+    };
+
+    for (size_t w = 0; w < workerCount; ++w) {
+        const CrawlWorker& worker = *run.workers[w];
+        for (size_t r = 0; r < worker.visited.size(); ++r) {
+            const VisitedDir& record = worker.visited[r];
+            uint32_t id = recordBase[w] + (uint32_t)r;
+            next.dirs[id] = { record.lastWriteTime, childBase[w] + record.firstChild, record.childCount, record.isProject };
+            if (record.parentWorker == CrawlDirTree::none) {
+                next.root = id;
+            } else {
+                const VisitedDir& parent = run.workers[record.parentWorker]->visited[record.parentRecord];
+                next.children[childBase[record.parentWorker] + parent.firstChild + record.childIndex].dir = id;
+            }
+        }
+        for (size_t c = 0; c < worker.children.size(); ++c) {
+            next.children[childBase[w] + c].name = intern(ChildName(previous, worker, worker.children[c]));
+        }
+    }
+    for (size_t w = 0; w < workerCount; ++w) {
+        const CrawlWorker& worker = *run.workers[w];
+        for (size_t c = 0; c < worker.children.size(); ++c) {
+            CrawlDirTree::Child& child = next.children[childBase[w] + c];
+            if (child.dir != CrawlDirTree::none) continue;
+            if (run.timedOut && worker.children[c].previous != CrawlDirTree::none) {
+                uint32_t copied = CopySubtree(previous, worker.children[c].previous, next, intern);
+                next.children[childBase[w] + c].dir = copied;
+            }
+        }
+    }
+
+    for (const auto& dir : next.dirs) {
+        auto begin = next.children.begin() + dir.firstChild;
+        std::sort(begin, begin + dir.childCount, [&next](const CrawlDirTree::Child& a, const CrawlDirTree::Child& b) {
+            return strcmp(next.Name(a), next.Name(b)) < 0;
+        });
+    }
+    next.dirs.shrink_to_fit();
+    next.children.shrink_to_fit();
+    next.names.shrink_to_fit();
+    tree = std::move(next);
+}
+
+static int NextDepth(const CrawlRun& run, const CrawlOptions& options) {
+    if (run.truncated) return std::max(run.maxDepth - 1, options.minDepth);
+    if (!run.timedOut && run.depthLimited && run.entries < options.entryBudget / 4) {
+        return std::min(run.maxDepth + 1, options.maxAdaptiveDepth);
+    }
+    return run.maxDepth;
+}
+
+CrawlResult CrawlerEngine::Crawl(const std::vector<std::string>& roots, const CrawlOptions& options) {
+    unsigned int workerCount = options.workerCount;
+    if (workerCount == 0) {
+        unsigned int totalWorkers = std::min(std::max(std::thread::hardware_concurrency(), 1u), 8u);
+        workerCount = std::max(2u, totalWorkers / (unsigned int)std::max<size_t>(roots.size(), 1));
+    }
+
+    std::unordered_map<std::string, RootState> nextStates;
+    for (const auto& root : roots) {
+        auto found = rootStates.find(root);
+        if (found != rootStates.end()) nextStates.emplace(root, std::move(found->second));
+        else nextStates[root].depth = options.maxDepth;
+    }
+    rootStates.swap(nextStates);
+
+    std::mutex batchMutex;
+    std::mutex rootDoneMutex;
+    std::vector<std::unique_ptr<CrawlRun>> runs;
+    std::vector<CrawlRootStats> stats(roots.size());
+    std::vector<std::vector<std::string>> rootFolders(roots.size());
+    std::vector<std::thread> jobs;
+    for (size_t r = 0; r < roots.size(); ++r) {
+        RootState& state = rootStates[roots[r]];
+        auto started = std::chrono::steady_clock::now();
+        runs.push_back(std::unique_ptr<CrawlRun>(new CrawlRun {
+            fs, roots[r], state.dirTree, options, batchMutex, state.depth,
+            started + std::chrono::milliseconds(options.timeBudgetMs), {}, {}, {}, {}, {}, {}, {} }));
+        jobs.emplace_back([&run = *runs.back(), &stat = stats[r], &folders = rootFolders[r], &rootDoneMutex, &options,
+                           root = roots[r], started, workerCount]() {
+            for (unsigned int i = 0; i < workerCount; ++i) run.workers.push_back(std::make_unique<CrawlWorker>());
+            PushTask(run, *run.workers[0], { root, 0, -1, run.previous.root, CrawlDirTree::none, 0, 0 });
+
+            std::vector<std::thread> threads;
+            for (unsigned int i = 1; i < workerCount; ++i) threads.emplace_back(RunWorker, std::ref(run), (size_t)i);
+            RunWorker(run, 0);
+            for (auto& thread : threads) thread.join();
+
+            stat.root = root;
+            stat.entries = run.entries;
+            stat.elapsedMs = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - started).count();
+            stat.depth = run.maxDepth;
+            stat.truncated = run.truncated;
+            stat.timedOut = run.timedOut;
+
+            size_t count = 0;
+            for (const auto& worker : run.workers) count += worker->results.size();
+            folders.reserve(count);
+            for (auto& worker : run.workers) {
+                std::move(worker->results.begin(), worker->results.end(), std::back_inserter(folders));
+                worker->results = std::vector<std::string>();
+            }
+            if (options.onRootDone) {
+                std::lock_guard<std::mutex> lock(rootDoneMutex);
+                options.onRootDone(stat, folders);
+            }
+        });
+    }
+    for (auto& job : jobs) job.join();
+
+    size_t total = 0;
+    for (const auto& folders : rootFolders) total += folders.size();
+
+    CrawlResult result;
+    result.stats = std::move(stats);
+    result.folders.reserve(total);
+    std::unordered_set<std::string_view> seen;
+    seen.reserve(total);
+    for (size_t r = 0; r < roots.size(); ++r) {
+        CrawlRun& run = *runs[r];
+        for (auto& path : rootFolders[r]) {
+            result.folders.push_back(std::move(path));
+            if (!seen.insert(result.folders.back()).second) result.folders.pop_back();
+        }
+        rootFolders[r] = std::vector<std::string>();
+
+        // A cancelled run saw only part of the tree, so the previous records
+        // stay as they were.
+        if (run.cancelled) {
+            result.cancelled = true;
+        } else {
+            RootState& state = rootStates[roots[r]];
+            state.depth = NextDepth(run, options);
+            BuildDirTree(run, state.dirTree);
+        }
+        run.workers.clear();
+    }
+    return result;
+}
+
+size_t CrawlerEngine::CacheByteSize() const {
+    size_t bytes = 0;
+    for (const auto& entry : rootStates) bytes += entry.second.dirTree.ByteSize();
+    return bytes;
+}
@@ -0,0 +1,138 @@
+#include "excludes.hpp"
+
+static const char* const anySegments = "**";
+
+static std::string NormalizePath(std::string_view text) {
+    std::string normalized(text);
+    for (auto& c : normalized) {
+        if (c == '\\') c = '/';
+        else if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+    }
+    return normalized;
+}
+
+static std::vector<std::string_view> SplitSegments(std::string_view path) {
+    std::vector<std::string_view> segments;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find('/', start);
+        if (end == std::string_view::npos) end = path.size();
+        if (end > start) segments.push_back(path.substr(start, end - start));
+        start = end + 1;
+    }
+    return segments;
+}
+
+// '*' and '?' within one segment. Only the latest '*' is ever retried, so a
+// mismatch costs at most one pass over the text per pattern character.
+static bool SegmentMatch(std::string_view pattern, std::string_view text) {
+    size_t p = 0;
+    size_t t = 0;
+    size_t star = std::string_view::npos;
+    size_t starText = 0;
+    while (t < text.size()) {
+        if (p < pattern.size() && pattern[p] == '*') {
+            while (p < pattern.size() && pattern[p] == '*') ++p;
+            star = p;
+            starText = t;
+        } else if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+            ++p;
+            ++t;
+        } else if (star != std::string_view::npos) {
+            p = star;
+            t = ++starText;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') ++p;
+    return p == pattern.size();
+}
+
+// The same retry-the-latest-star walk one level up, with "**" segments
+// spanning any number of text segments.
+static bool SegmentsMatch(const std::vector<std::string>& pattern, const std::vector<std::string_view>& text,
+                          size_t t) {
+    size_t p = 0;
+    size_t star = std::string::npos;
+    size_t starText = 0;
+    while (t < text.size()) {
+        if (p < pattern.size() && pattern[p] == anySegments) {
+            star = ++p;
+            starText = t;
+        } else if (p < pattern.size() && SegmentMatch(pattern[p], text[t])) {
+            ++p;
+            ++t;
+        } else if (star != std::string::npos) {
+            p = star;
+            t = ++starText;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == anySegments) ++p;
+    return p == pattern.size();
+}
+
+static bool IsAbsolutePattern(const std::string& pattern) {
+    if (pattern.compare(0, 2, "//") == 0) return true;
+    return pattern.size() >= 2 && pattern[1] == ':' && pattern[0] >= 'a' && pattern[0] <= 'z';
+}
+
+void ExcludeRules::Compile(const std::vector<std::string>& patterns) {
+    names.clear();
+    nameGlobs.clear();
+    pathGlobs.clear();
+    hasRootGlobs = false;
+
+    for (const auto& raw : patterns) {
+        std::string pattern = NormalizePath(raw);
+        while (!pattern.empty() && pattern.back() == '/') pattern.pop_back();
+        while (pattern.compare(0, 3, "**/") == 0) pattern.erase(0, 3);
+        if (pattern.empty()) continue;
+
+        if (pattern.find('/') == std::string::npos) {
+            if (pattern.find_first_of("*?") != std::string::npos) nameGlobs.push_back(pattern);
+            else names.insert(pattern);
+            continue;
+        }
+
+        PathGlob glob;
+        glob.anchor = IsAbsolutePattern(pattern) ? Anchor::Absolute : pattern[0] == '/' ? Anchor::Root : Anchor::Floating;
+        if (glob.anchor == Anchor::Floating) glob.segments.push_back(anySegments);
+        for (std::string_view segment : SplitSegments(pattern)) glob.segments.emplace_back(segment);
+        // A trailing "**" covers what is inside a folder, not the folder.
+        if (glob.segments.back() == anySegments) {
+            glob.segments.back() = "*";
+            glob.segments.push_back(anySegments);
+        }
+        hasRootGlobs = hasRootGlobs || glob.anchor == Anchor::Root;
+        pathGlobs.push_back(std::move(glob));
+    }
+}
+
+bool ExcludeRules::Matches(std::string_view name, std::string_view fullPath, std::string_view root) const {
+    if (!names.empty() || !nameGlobs.empty()) {
+        std::string lowerName = NormalizePath(name);
+        if (names.count(lowerName)) return true;
+        for (const auto& glob : nameGlobs) {
+            if (SegmentMatch(glob, lowerName)) return true;
+        }
+    }
+    if (!pathGlobs.empty()) {
+        std::string path = NormalizePath(fullPath);
+        std::vector<std::string_view> segments = SplitSegments(path);
+        size_t rootSegments = 0;
+        if (hasRootGlobs) {
+            std::string lowerRoot = NormalizePath(root);
+            bool isUnderRoot = path.compare(0, lowerRoot.size(), lowerRoot) == 0 &&
+                               (path.size() == lowerRoot.size() || path[lowerRoot.size()] == '/' ||
+                                (!lowerRoot.empty() && lowerRoot.back() == '/'));
+            if (isUnderRoot) rootSegments = SplitSegments(lowerRoot).size();
+        }
+        for (const auto& glob : pathGlobs) {
+            if (SegmentsMatch(glob.segments, segments, glob.anchor == Anchor::Root ? rootSegments : 0)) return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,624 @@
+#include "folderindex.hpp"
+#include "matcher.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <unordered_map>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t count;
+    uint32_t blocksSize;
+    uint32_t trigramCount;
+    uint32_t postingsSize;
+};
+
+static const char snapshotMagic[4] = { 'K', 'N', 'I', 'X' };
+
+static size_t BlockCount(size_t count) {
+    return (count + FolderIndex::blockSize - 1) / FolderIndex::blockSize;
+}
+
+static char LowerChar(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+static uint32_t TrigramKey(const char* p) {
+    return ((uint32_t)(unsigned char)p[0] << 16) | ((uint32_t)(unsigned char)p[1] << 8) | (unsigned char)p[2];
+}
+
+static void AppendVarint(std::vector<uint8_t>& bytes, uint32_t value) {
+    while (value >= 0x80) {
+        bytes.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back((uint8_t)value);
+}
+
+static bool ReadVarint(const uint8_t*& cursor, const uint8_t* end, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; cursor < end && shift < 35; shift += 7) {
+        uint8_t byte = *cursor++;
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+static void DecodePostings(const uint8_t* begin, const uint8_t* end, std::vector<uint32_t>& ids) {
+    ids.clear();
+    uint32_t id = 0;
+    while (begin < end) {
+        uint32_t delta = 0;
+        int shift = 0;
+        while (begin < end) {
+            uint8_t byte = *begin++;
+            delta |= (uint32_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) break;
+            shift += 7;
+        }
+        id += delta;
+        ids.push_back(id);
+    }
+}
+
+bool ReplaceFileWith(const std::string& tempPath, const std::string& filePath) {
+#ifdef _WIN32
+    bool isRenamed = MoveFileExA(tempPath.c_str(), filePath.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bool isRenamed = std::rename(tempPath.c_str(), filePath.c_str()) == 0;
+#endif
+    if (!isRenamed) std::remove(tempPath.c_str());
+    return isRenamed;
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+#ifdef _WIN32
+bool MappedFile::Open(const std::string& filePath) {
+    Close();
+
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mappingHandle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mappingHandle) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mappingHandle);
+        CloseHandle(file);
+        return false;
+    }
+
+    hFile = file;
+    hMapping = mappingHandle;
+    data = (const unsigned char*)view;
+    size = (size_t)fileSize.QuadPart;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data) UnmapViewOfFile(data);
+    if (hMapping) CloseHandle((HANDLE)hMapping);
+    if (hFile) CloseHandle((HANDLE)hFile);
+    data = nullptr;
+    size = 0;
+    hMapping = nullptr;
+    hFile = nullptr;
+}
+#else
+bool MappedFile::Open(const std::string& filePath) {
+    Close();
+
+    int file = open(filePath.c_str(), O_RDONLY);
+    if (file < 0) return false;
+
+    struct stat st;
+    if (fstat(file, &st) != 0 || st.st_size == 0) {
+        close(file);
+        return false;
+    }
+
+    void* view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, file, 0);
+    if (view == MAP_FAILED) {
+        close(file);
+        return false;
+    }
+
+    fd = file;
+    data = (const unsigned char*)view;
+    size = (size_t)st.st_size;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data) munmap((void*)data, size);
+    if (fd >= 0) close(fd);
+    data = nullptr;
+    size = 0;
+    fd = -1;
+}
+#endif
+
+void FolderIndex::Build(const std::vector<std::string>& paths) {
+    Clear();
+
+    std::vector<const std::string*> sorted;
+    sorted.reserve(paths.size());
+    for (const auto& path : paths) sorted.push_back(&path);
+    std::sort(sorted.begin(), sorted.end(), [](const std::string* a, const std::string* b) { return *a < *b; });
+
+    ownedBlockOffsets.reserve(BlockCount(sorted.size()) + 1);
+    std::string_view previous;
+    for (const std::string* path : sorted) {
+        if (!AppendPath(*path, previous)) break;
+        previous = *path;
+    }
+    FinishBuild();
+}
+
+// Walks base's sorted paths once and merges the sorted additions in, so no
+// path is copied out and nothing is sorted again but the additions.
+void FolderIndex::BuildReplaced(const FolderIndex& base, std::vector<IdRange> removed, std::vector<std::string> added) {
+    Clear();
+
+    std::sort(added.begin(), added.end());
+    added.erase(std::unique(added.begin(), added.end()), added.end());
+    std::sort(removed.begin(), removed.end(), [](const IdRange& a, const IdRange& b) { return a.begin < b.begin; });
+
+    ownedBlockOffsets.reserve(BlockCount(base.Size() + added.size()) + 1);
+    Decoder decoder(base);
+    std::string previous;
+    size_t next = 0;
+    size_t r = 0;
+    bool isFull = false;
+    auto append = [&](std::string_view path) {
+        if (isFull || !AppendPath(path, previous)) {
+            isFull = true;
+            return;
+        }
+        previous.assign(path.data(), path.size());
+    };
+    for (size_t id = 0; id < base.Size() && !isFull; ++id) {
+        while (r < removed.size() && removed[r].end <= id) ++r;
+        if (r < removed.size() && removed[r].begin <= id) {
+            id = removed[r].end - 1;
+            continue;
+        }
+        decoder.Seek(id);
+        std::string_view path = decoder.Path();
+        while (next < added.size() && added[next] < path) append(added[next++]);
+        if (next < added.size() && added[next] == path) ++next;
+        append(path);
+    }
+    while (next < added.size()) append(added[next++]);
+    FinishBuild();
+}
+
+bool FolderIndex::AppendPath(std::string_view path, std::string_view previous) {
+    size_t shared = 0;
+    if (count % blockSize == 0) {
+        if (ownedBlocks.size() > std::numeric_limits<uint32_t>::max()) return false;
+        ownedBlockOffsets.push_back((uint32_t)ownedBlocks.size());
+    } else {
+        size_t limit = std::min(previous.size(), path.size());
+        while (shared < limit && previous[shared] == path[shared]) ++shared;
+        AppendVarint(ownedBlocks, (uint32_t)shared);
+    }
+    AppendVarint(ownedBlocks, (uint32_t)(path.size() - shared));
+    ownedBlocks.insert(ownedBlocks.end(), path.begin() + shared, path.end());
+    ++count;
+    return true;
+}
+
+void FolderIndex::FinishBuild() {
+    if (ownedBlocks.size() > std::numeric_limits<uint32_t>::max()) {
+        Clear();
+        return;
+    }
+    ownedBlockOffsets.push_back((uint32_t)ownedBlocks.size());
+
+    blockOffsets = ownedBlockOffsets.data();
+    blocks = ownedBlocks.data();
+
+    BuildSearchTables();
+}
+
+void FolderIndex::Decoder::Seek(size_t id) {
+    if (id < next || id >= (next + blockSize - 1) / blockSize * blockSize) {
+        size_t block = id / blockSize;
+        cursor = index.blocks + index.blockOffsets[block];
+        blockEnd = index.blocks + index.blockOffsets[block + 1];
+        next = block * blockSize;
+        path.clear();
+        lowerPath.clear();
+        basename = 0;
+    }
+    while (next <= id) DecodeNext();
+}
+
+void FolderIndex::Decoder::DecodeNext() {
+    uint32_t shared = 0;
+    uint32_t suffixLength = 0;
+    if (next % blockSize != 0 && !ReadVarint(cursor, blockEnd, shared)) shared = 0;
+    if (!ReadVarint(cursor, blockEnd, suffixLength)) suffixLength = 0;
+    shared = std::min<uint32_t>(shared, (uint32_t)path.size());
+    suffixLength = std::min<uint32_t>(suffixLength, (uint32_t)(blockEnd - cursor));
+
+    path.resize(shared + suffixLength);
+    lowerPath.resize(shared + suffixLength);
+    size_t suffixSeparator = std::string::npos;
+    for (uint32_t i = 0; i < suffixLength; ++i) {
+        char c = (char)cursor[i];
+        path[shared + i] = c;
+        lowerPath[shared + i] = LowerChar(c);
+        if (c == '\\' || c == '/') suffixSeparator = shared + i;
+    }
+    cursor += suffixLength;
+
+    // The basename only moves when the new suffix holds a separator or
+    // the shared prefix ends before the previous basename started.
+    if (suffixSeparator != std::string::npos) {
+        basename = suffixSeparator + 1;
+    } else if (basename > shared) {
+        size_t separator = path.find_last_of("\\/");
+        basename = separator == std::string::npos ? 0 : separator + 1;
+    }
+    ++next;
+}
+
+std::string FolderIndex::Path(size_t i) const {
+    Decoder decoder(*this);
+    decoder.Seek(i);
+    return std::string(decoder.Path());
+}
+
+// Binary search over the whole first paths of the blocks, then a decode
+// of the one block the key falls into.
+size_t FolderIndex::LowerBound(std::string_view key) const {
+    size_t low = 0;
+    size_t high = BlockCount(count);
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        const uint8_t* cursor = blocks + blockOffsets[mid];
+        const uint8_t* end = blocks + blockOffsets[mid + 1];
+        uint32_t length = 0;
+        if (!ReadVarint(cursor, end, length)) length = 0;
+        std::string_view head((const char*)cursor, std::min<size_t>(length, (size_t)(end - cursor)));
+        if (head < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low == 0) return 0;
+
+    Decoder decoder(*this);
+    size_t id = (low - 1) * blockSize;
+    size_t blockEnd = std::min(low * blockSize, count);
+    for (; id < blockEnd; ++id) {
+        decoder.Seek(id);
+        if (decoder.Path() >= key) break;
+    }
+    return id;
+}
+
+IdRange FolderIndex::PrefixRange(std::string_view prefix) const {
+    size_t begin = LowerBound(prefix);
+    std::string upper(prefix);
+    while (!upper.empty() && (unsigned char)upper.back() == 0xFF) upper.pop_back();
+    if (upper.empty()) return { (uint32_t)begin, (uint32_t)count };
+    upper.back() = (char)((unsigned char)upper.back() + 1);
+    return { (uint32_t)begin, (uint32_t)LowerBound(upper) };
+}
+
+void FolderIndex::BuildSearchTables() {
+    struct PostingBuilder {
+        std::vector<uint8_t> bytes;
+        uint32_t lastId = 0;
+    };
+    std::unordered_map<uint32_t, PostingBuilder> builders;
+    std::vector<uint32_t> blockTrigrams;
+    std::string previous;
+
+    // Trigrams and characters of the prefix a path shares with the one
+    // before it in the block are already counted, so only the rest is read.
+    size_t blockCount = BlockCount(count);
+    ownedCharMasks.assign(blockCount, 0);
+    Decoder decoder(*this);
+    for (size_t block = 0; block < blockCount; ++block) {
+        blockTrigrams.clear();
+        previous.clear();
+        size_t blockEnd = std::min((block + 1) * blockSize, count);
+        for (size_t i = block * blockSize; i < blockEnd; ++i) {
+            decoder.Seek(i);
+            std::string_view lowerPath = decoder.LowerPath();
+            size_t shared = 0;
+            size_t limit = std::min(previous.size(), lowerPath.size());
+            while (shared < limit && previous[shared] == lowerPath[shared]) ++shared;
+            ownedCharMasks[block] |= ::CharMask(lowerPath.substr(shared));
+            for (size_t j = shared >= 2 ? shared - 2 : 0; j + 3 <= lowerPath.size(); ++j) {
+                blockTrigrams.push_back(TrigramKey(lowerPath.data() + j));
+            }
+            previous.assign(lowerPath.data(), lowerPath.size());
+        }
+        std::sort(blockTrigrams.begin(), blockTrigrams.end());
+        blockTrigrams.erase(std::unique(blockTrigrams.begin(), blockTrigrams.end()), blockTrigrams.end());
+
+        for (uint32_t key : blockTrigrams) {
+            PostingBuilder& builder = builders[key];
+            AppendVarint(builder.bytes, (uint32_t)block - builder.lastId);
+            builder.lastId = (uint32_t)block;
+        }
+    }
+
+    ownedTrigramKeys.reserve(builders.size());
+    for (const auto& entry : builders) ownedTrigramKeys.push_back(entry.first);
+    std::sort(ownedTrigramKeys.begin(), ownedTrigramKeys.end());
+
+    size_t postingsSize = 0;
+    for (const auto& entry : builders) postingsSize += entry.second.bytes.size();
+    ownedPostings.reserve(postingsSize);
+    ownedPostingOffsets.reserve(ownedTrigramKeys.size() + 1);
+    for (uint32_t key : ownedTrigramKeys) {
+        const auto& bytes = builders[key].bytes;
+        ownedPostingOffsets.push_back((uint32_t)ownedPostings.size());
+        ownedPostings.insert(ownedPostings.end(), bytes.begin(), bytes.end());
+    }
+    ownedPostingOffsets.push_back((uint32_t)ownedPostings.size());
+
+    charMasks = ownedCharMasks.data();
+    trigramKeys = ownedTrigramKeys.data();
+    postingOffsets = ownedPostingOffsets.data();
+    postings = ownedPostings.data();
+    trigramCount = ownedTrigramKeys.size();
+}
+
+// Returns a superset of the paths containing lowerPattern, every path of each
+// block that holds all of its trigrams; callers verify each candidate.
+// Intersection stops early once the remaining lists are much longer than the
+// candidate set, since verifying is cheaper than decoding them.
+bool FolderIndex::TrigramCandidates(std::string_view lowerPattern, std::vector<uint32_t>& candidates) const {
+    if (lowerPattern.size() < 3) return false;
+    candidates.clear();
+
+    std::vector<uint32_t> patternTrigrams;
+    for (size_t j = 0; j + 3 <= lowerPattern.size(); ++j) patternTrigrams.push_back(TrigramKey(lowerPattern.data() + j));
+    std::sort(patternTrigrams.begin(), patternTrigrams.end());
+    patternTrigrams.erase(std::unique(patternTrigrams.begin(), patternTrigrams.end()), patternTrigrams.end());
+
+    std::vector<size_t> lists;
+    for (uint32_t key : patternTrigrams) {
+        const uint32_t* found = std::lower_bound(trigramKeys, trigramKeys + trigramCount, key);
+        if (found == trigramKeys + trigramCount || *found != key) return true;
+        lists.push_back(found - trigramKeys);
+    }
+    std::sort(lists.begin(), lists.end(), [this](size_t a, size_t b) {
+        return postingOffsets[a + 1] - postingOffsets[a] < postingOffsets[b + 1] - postingOffsets[b];
+    });
+
+    std::vector<uint32_t> candidateBlocks;
+    DecodePostings(postings + postingOffsets[lists[0]], postings + postingOffsets[lists[0] + 1], candidateBlocks);
+    std::vector<uint32_t> other;
+    std::vector<uint32_t> merged;
+    for (size_t k = 1; k < lists.size() && !candidateBlocks.empty(); ++k) {
+        size_t listBytes = postingOffsets[lists[k] + 1] - postingOffsets[lists[k]];
+        if (candidateBlocks.size() * 16 < listBytes) break;
+        DecodePostings(postings + postingOffsets[lists[k]], postings + postingOffsets[lists[k] + 1], other);
+        merged.clear();
+        std::set_intersection(candidateBlocks.begin(), candidateBlocks.end(), other.begin(), other.end(),
+                              std::back_inserter(merged));
+        candidateBlocks.swap(merged);
+    }
+
+    candidates.reserve(candidateBlocks.size() * blockSize);
+    for (uint32_t block : candidateBlocks) {
+        size_t blockEnd = std::min((block + 1) * blockSize, count);
+        for (size_t id = block * blockSize; id < blockEnd; ++id) candidates.push_back((uint32_t)id);
+    }
+    return true;
+}
+
+bool FolderIndex::Save(const std::string& filePath) const {
+    std::string tempPath = filePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        uint32_t zeroOffset = 0;
+        size_t blockCount = BlockCount(count);
+        SnapshotHeader header;
+        memcpy(header.magic, snapshotMagic, sizeof(header.magic));
+        header.version = snapshotVersion;
+        header.count = (uint32_t)count;
+        header.blocksSize = count ? blockOffsets[blockCount] : 0;
+        header.trigramCount = (uint32_t)trigramCount;
+        header.postingsSize = postingOffsets ? postingOffsets[trigramCount] : 0;
+
+        file.write((const char*)&header, sizeof(header));
+        file.write((const char*)charMasks, blockCount * sizeof(uint64_t));
+        file.write((const char*)(count ? blockOffsets : &zeroOffset), (blockCount + 1) * sizeof(uint32_t));
+        file.write((const char*)trigramKeys, trigramCount * sizeof(uint32_t));
+        file.write((const char*)(postingOffsets ? postingOffsets : &zeroOffset), (trigramCount + 1) * sizeof(uint32_t));
+        file.write((const char*)blocks, header.blocksSize);
+        file.write((const char*)postings, header.postingsSize);
+        file.close();
+        if (!file.good()) {
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    return ReplaceFileWith(tempPath, filePath);
+}
+
+bool FolderIndex::Load(const std::string& filePath) {
+    auto file = std::make_unique<MappedFile>();
+    if (!file->Open(filePath)) return false;
+    if (file->Size() < sizeof(SnapshotHeader)) return false;
+
+    SnapshotHeader header;
+    memcpy(&header, file->Data(), sizeof(header));
+    if (memcmp(header.magic, snapshotMagic, sizeof(header.magic)) != 0) return false;
+    if (header.version != snapshotVersion) return false;
+
+    size_t blockCount = BlockCount(header.count);
+    uint64_t charMasksBytes = (uint64_t)blockCount * sizeof(uint64_t);
+    uint64_t blockOffsetsBytes = ((uint64_t)blockCount + 1) * sizeof(uint32_t);
+    uint64_t trigramKeysBytes = (uint64_t)header.trigramCount * sizeof(uint32_t);
+    uint64_t postingOffsetsBytes = ((uint64_t)header.trigramCount + 1) * sizeof(uint32_t);
+    uint64_t expectedSize = sizeof(SnapshotHeader) + charMasksBytes + blockOffsetsBytes + trigramKeysBytes +
+                            postingOffsetsBytes + (uint64_t)header.blocksSize + header.postingsSize;
+    if (file->Size() != expectedSize) return false;
+
+    const unsigned char* cursor = file->Data() + sizeof(SnapshotHeader);
+    const uint64_t* fileCharMasks = (const uint64_t*)cursor;
+    cursor += charMasksBytes;
+    const uint32_t* fileBlockOffsets = (const uint32_t*)cursor;
+    if (fileBlockOffsets[0] != 0 || fileBlockOffsets[blockCount] != header.blocksSize) return false;
+    for (size_t i = 0; i < blockCount; ++i) {
+        if (fileBlockOffsets[i] > fileBlockOffsets[i + 1]) return false;
+    }
+    cursor += blockOffsetsBytes;
+    const uint32_t* fileTrigramKeys = (const uint32_t*)cursor;
+    cursor += trigramKeysBytes;
+    const uint32_t* filePostingOffsets = (const uint32_t*)cursor;
+    cursor += postingOffsetsBytes;
+    if (filePostingOffsets[0] != 0 || filePostingOffsets[header.trigramCount] != header.postingsSize) return false;
+
+    Clear();
+    charMasks = fileCharMasks;
+    blockOffsets = fileBlockOffsets;
+    trigramKeys = fileTrigramKeys;
+    postingOffsets = filePostingOffsets;
+    trigramCount = header.trigramCount;
+    blocks = (const uint8_t*)cursor;
+    postings = (const uint8_t*)cursor + header.blocksSize;
+    count = header.count;
+    mapping = std::move(file);
+    return true;
+}
+
+size_t FolderIndex::ByteSize() const {
+    if (count == 0) return 0;
+    size_t blockCount = BlockCount(count);
+    size_t bytes = blockCount * sizeof(uint64_t) + (blockCount + 1) * sizeof(uint32_t) + blockOffsets[blockCount];
+    if (trigramCount) bytes += trigramCount * sizeof(uint32_t) + (trigramCount + 1) * sizeof(uint32_t) + postingOffsets[trigramCount];
+    return bytes;
+}
+
+void FolderIndex::Clear() {
+    charMasks = nullptr;
+    blockOffsets = nullptr;
+    blocks = nullptr;
+    count = 0;
+    trigramKeys = nullptr;
+    postingOffsets = nullptr;
+    postings = nullptr;
+    trigramCount = 0;
+    ownedCharMasks.clear();
+    ownedCharMasks.shrink_to_fit();
+    ownedBlockOffsets.clear();
+    ownedBlockOffsets.shrink_to_fit();
+    ownedBlocks.clear();
+    ownedBlocks.shrink_to_fit();
+    ownedTrigramKeys.clear();
+    ownedTrigramKeys.shrink_to_fit();
+    ownedPostingOffsets.clear();
+    ownedPostingOffsets.shrink_to_fit();
+    ownedPostings.clear();
+    ownedPostings.shrink_to_fit();
+    mapping.reset();
+}
+
+std::string SnapshotFiles::PathFor(uint64_t fileGeneration) const {
+    std::string name = fileGeneration == 0 ? stem + ".idx" : stem + "." + std::to_string(fileGeneration) + ".idx";
+    return (std::filesystem::path(directory) / name).string();
+}
+
+// Generations present on disk, newest first. Leftover .tmp files are not
+// snapshots and are only ever removed.
+std::vector<uint64_t> SnapshotFiles::Generations() const {
+    std::vector<uint64_t> found;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() <= stem.size() || name.compare(0, stem.size(), stem) != 0) continue;
+        std::string rest = name.substr(stem.size());
+        if (rest == ".idx") {
+            found.push_back(0);
+            continue;
+        }
+        if (rest.size() < 6 || rest[0] != '.' || rest.compare(rest.size() - 4, 4, ".idx") != 0) continue;
+        std::string digits = rest.substr(1, rest.size() - 5);
+        if (digits.empty() || digits.find_first_not_of("0123456789") != std::string::npos) continue;
+        found.push_back(std::stoull(digits));
+    }
+    std::sort(found.rbegin(), found.rend());
+    return found;
+}
+
+void SnapshotFiles::RemoveOlder(uint64_t current) const {
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0 && name.compare(0, stem.size(), stem) == 0) {
+            std::filesystem::remove(entry.path(), error);
+        }
+    }
+    for (uint64_t older : Generations()) {
+        if (older < current) std::filesystem::remove(PathFor(older), error);
+    }
+}
+
+bool SnapshotFiles::LoadNewest(FolderIndex& index) {
+    std::vector<uint64_t> generations = Generations();
+    if (!generations.empty()) generation = generations.front();
+    for (uint64_t candidate : generations) {
+        if (index.Load(PathFor(candidate))) return true;
+    }
+    return false;
+}
+
+bool SnapshotFiles::Save(const FolderIndex& index) {
+    uint64_t next = generation + 1;
+    for (uint64_t existing : Generations()) next = std::max(next, existing + 1);
+    if (!index.Save(PathFor(next))) return false;
+    generation = next;
+    RemoveOlder(generation);
+    return true;
+}
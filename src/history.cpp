@@ -0,0 +1,215 @@
+#include "history.hpp"
+#include "folderindex.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+
+static const double frecencyHalfLifeSeconds = 14.0 * 24.0 * 3600.0;
+static const double frecencyBonusWeight = 16.0;
+static const int64_t legacyRankSpacingSeconds = 3600;
+static const char sequenceHeader[] = "#sequence\t";
+
+void FrecencyStore::Clear() {
+    entries.clear();
+    lookup.clear();
+    sequence = 0;
+}
+
+HistoryEntry& FrecencyStore::Upsert(const std::string& path) {
+    auto found = lookup.find(path);
+    if (found != lookup.end()) return entries[found->second];
+    lookup.emplace(path, entries.size());
+    entries.push_back(HistoryEntry());
+    entries.back().path = path;
+    return entries.back();
+}
+
+double FrecencyStore::Score(const HistoryEntry& entry, int64_t now) const {
+    double age = (double)std::max<int64_t>(now - entry.lastLaunch, 0);
+    return entry.frecency * std::exp2(-age / frecencyHalfLifeSeconds);
+}
+
+uint64_t FrecencyStore::Record(const std::string& path, int64_t now) {
+    HistoryEntry& entry = Upsert(path);
+    entry.frecency = Score(entry, now) + 1.0;
+    entry.launchCount++;
+    entry.lastLaunch = now;
+    return ++sequence;
+}
+
+bool FrecencyStore::Load(const std::string& filePath, int64_t now) {
+    std::ifstream file(filePath);
+    if (!file.is_open()) return false;
+
+    Clear();
+    std::string line;
+    int64_t legacyRank = 0;
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+        if (line.compare(0, sizeof(sequenceHeader) - 1, sequenceHeader) == 0) {
+            sequence = std::strtoull(line.c_str() + sizeof(sequenceHeader) - 1, nullptr, 10);
+            continue;
+        }
+
+        size_t countEnd = line.find('\t');
+        if (countEnd == std::string::npos) {
+            HistoryEntry& entry = Upsert(line);
+            if (entry.launchCount == 0) {
+                entry.launchCount = 1;
+                entry.lastLaunch = now - legacyRank++ * legacyRankSpacingSeconds;
+                entry.frecency = 1.0;
+            }
+            continue;
+        }
+        size_t lastEnd = line.find('\t', countEnd + 1);
+        size_t frecencyEnd = lastEnd == std::string::npos ? std::string::npos : line.find('\t', lastEnd + 1);
+        if (frecencyEnd == std::string::npos || frecencyEnd + 1 >= line.size()) continue;
+
+        HistoryEntry& entry = Upsert(line.substr(frecencyEnd + 1));
+        entry.launchCount = (uint32_t)std::strtoul(line.c_str(), nullptr, 10);
+        entry.lastLaunch = std::strtoll(line.c_str() + countEnd + 1, nullptr, 10);
+        entry.frecency = std::strtod(line.c_str() + lastEnd + 1, nullptr);
+    }
+    return true;
+}
+
+bool FrecencyStore::Save(const std::string& filePath) const {
+    std::ofstream file(filePath, std::ios::trunc);
+    if (!file.is_open()) return false;
+    // 17 significant digits read back as the same double.
+    file << std::setprecision(17);
+    file << sequenceHeader << sequence << "\n";
+    for (const auto& entry : entries) {
+        file << entry.launchCount << "\t" << entry.lastLaunch << "\t" << entry.frecency << "\t" << entry.path << "\n";
+    }
+    return file.good();
+}
+
+size_t FrecencyStore::Replay(const std::string& journalPath) {
+    std::ifstream file(journalPath);
+    if (!file.is_open()) return 0;
+
+    size_t replayed = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t firstEnd = line.find('\t');
+        if (firstEnd == std::string::npos || firstEnd + 1 >= line.size()) continue;
+        size_t secondEnd = line.find('\t', firstEnd + 1);
+
+        if (secondEnd == std::string::npos) {
+            std::string path = line.substr(firstEnd + 1);
+            int64_t time = std::strtoll(line.c_str(), nullptr, 10);
+            auto found = lookup.find(path);
+            if (found != lookup.end() && time <= entries[found->second].lastLaunch) continue;
+            Record(path, time);
+            ++replayed;
+            continue;
+        }
+
+        if (secondEnd + 1 >= line.size()) continue;
+        uint64_t recordSequence = std::strtoull(line.c_str(), nullptr, 10);
+        if (recordSequence <= sequence) continue;
+        Record(line.substr(secondEnd + 1), std::strtoll(line.c_str() + firstEnd + 1, nullptr, 10));
+        sequence = recordSequence;
+        ++replayed;
+    }
+    return replayed;
+}
+
+void HistoryJournal::Start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (worker.joinable()) return;
+    isStopping = false;
+    worker = std::thread(&HistoryJournal::Run, this);
+}
+
+void HistoryJournal::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopping = true;
+    }
+    condition.notify_one();
+    if (worker.joinable()) worker.join();
+}
+
+void HistoryJournal::Append(const std::string& journalPath, uint64_t sequence, const std::string& path, int64_t time) {
+    Task task;
+    task.journalPath = journalPath;
+    task.line = std::to_string(sequence) + "\t" + std::to_string(time) + "\t" + path + "\n";
+    Push(std::move(task));
+}
+
+void HistoryJournal::Compact(const std::string& historyPath, const std::string& journalPath, const FrecencyStore& store) {
+    Task task;
+    task.journalPath = journalPath;
+    task.historyPath = historyPath;
+    task.store = std::make_shared<FrecencyStore>(store);
+    Push(std::move(task));
+}
+
+void HistoryJournal::Push(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    condition.notify_one();
+}
+
+// Drains the queue before exiting, so nothing recorded before Stop is lost.
+void HistoryJournal::Run() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return isStopping || !tasks.empty(); });
+            if (tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        if (!task.store) {
+            std::ofstream journal(task.journalPath, std::ios::app);
+            journal << task.line;
+            continue;
+        }
+
+        std::string tempPath = task.historyPath + ".tmp";
+        if (!task.store->Save(tempPath)) continue;
+        if (!ReplaceFileWith(tempPath, task.historyPath)) continue;
+        std::ofstream journal(task.journalPath, std::ios::trunc);
+    }
+}
+
+std::shared_ptr<const HistorySnapshot> BuildHistorySnapshot(const FrecencyStore& store, int64_t now) {
+    const auto& entries = store.Entries();
+
+    std::vector<std::pair<double, size_t>> ranked;
+    ranked.reserve(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) ranked.push_back({ store.Score(entries[i], now), i });
+    std::sort(ranked.begin(), ranked.end(), [&](const auto& a, const auto& b) {
+        if (a.first != b.first) return a.first > b.first;
+        return entries[a.second].lastLaunch > entries[b.second].lastLaunch;
+    });
+
+    auto snapshot = std::make_shared<HistorySnapshot>();
+    for (const auto& rank : ranked) {
+        const std::string& path = entries[rank.second].path;
+        std::string lowerPath = path;
+        for (auto& c : lowerPath) c = (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+        size_t separator = path.find_last_of("\\/");
+
+        snapshot->paths.push_back(path);
+        snapshot->lowerPaths.push_back(std::move(lowerPath));
+        snapshot->basenames.push_back(separator == std::string::npos ? 0 : separator + 1);
+        snapshot->rankBonus.push_back((int)std::lround(frecencyBonusWeight * std::log2(1.0 + rank.first)));
+    }
+
+    snapshot->lookup.reserve(snapshot->paths.size());
+    for (size_t i = 0; i < snapshot->paths.size(); ++i) {
+        snapshot->lookup.emplace(snapshot->paths[i], (uint32_t)i);
+    }
+    return snapshot;
+}
@@ -0,0 +1,87 @@
+#include "imagekernel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Which source pixels cover one target pixel, and by how much.
+struct AxisSpan {
+    int first;
+    std::vector<float> weights;
+};
+
+static std::vector<AxisSpan> AxisSpans(int sourceSize, int targetSize) {
+    std::vector<AxisSpan> spans(targetSize);
+    double scale = (double)sourceSize / targetSize;
+    for (int t = 0; t < targetSize; ++t) {
+        double begin = t * scale;
+        double end = std::min((t + 1) * scale, (double)sourceSize);
+        AxisSpan& span = spans[t];
+        span.first = std::min((int)begin, sourceSize - 1);
+        double total = 0.0;
+        for (int s = span.first; s < sourceSize && s < end; ++s) {
+            double coverage = std::min(end, s + 1.0) - std::max(begin, (double)s);
+            if (coverage <= 0.0) continue;
+            span.weights.push_back((float)coverage);
+            total += coverage;
+        }
+        if (span.weights.empty()) {
+            span.weights.push_back(1.0f);
+            total = 1.0;
+        }
+        for (auto& weight : span.weights) weight = (float)(weight / total);
+    }
+    return spans;
+}
+
+void ScaleAndFade(const PixelBuffer& source, int width, int height, float opacity, PixelBuffer& target) {
+    target.width = std::max(width, 0);
+    target.height = std::max(height, 0);
+    target.pixels.assign((size_t)target.width * target.height, 0);
+    if (source.Empty() || target.pixels.empty()) return;
+
+    // Premultiply once, then run the two separable passes on floats.
+    std::vector<float> premultiplied((size_t)source.width * source.height * 4);
+    for (size_t i = 0; i < (size_t)source.width * source.height; ++i) {
+        uint32_t pixel = source.pixels[i];
+        float alpha = (float)(pixel >> 24) / 255.0f;
+        premultiplied[i * 4 + 0] = (float)(pixel & 0xFF) * alpha;
+        premultiplied[i * 4 + 1] = (float)((pixel >> 8) & 0xFF) * alpha;
+        premultiplied[i * 4 + 2] = (float)((pixel >> 16) & 0xFF) * alpha;
+        premultiplied[i * 4 + 3] = (float)(pixel >> 24);
+    }
+
+    std::vector<AxisSpan> columns = AxisSpans(source.width, target.width);
+    std::vector<AxisSpan> rows = AxisSpans(source.height, target.height);
+
+    std::vector<float> horizontal((size_t)target.width * source.height * 4, 0.0f);
+    for (int y = 0; y < source.height; ++y) {
+        const float* sourceRow = &premultiplied[(size_t)y * source.width * 4];
+        float* targetRow = &horizontal[(size_t)y * target.width * 4];
+        for (int x = 0; x < target.width; ++x) {
+            const AxisSpan& span = columns[x];
+            float* out = targetRow + x * 4;
+            for (size_t k = 0; k < span.weights.size(); ++k) {
+                const float* in = sourceRow + (span.first + k) * 4;
+                for (int c = 0; c < 4; ++c) out[c] += in[c] * span.weights[k];
+            }
+        }
+    }
+
+    float fade = std::min(std::max(opacity, 0.0f), 1.0f);
+    for (int y = 0; y < target.height; ++y) {
+        const AxisSpan& span = rows[y];
+        for (int x = 0; x < target.width; ++x) {
+            float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            for (size_t k = 0; k < span.weights.size(); ++k) {
+                const float* in = &horizontal[((size_t)(span.first + k) * target.width + x) * 4];
+                for (int c = 0; c < 4; ++c) sum[c] += in[c] * span.weights[k];
+            }
+            uint32_t pixel = 0;
+            for (int c = 0; c < 4; ++c) {
+                uint32_t value = (uint32_t)std::lround(std::min(sum[c] * fade, 255.0f));
+                pixel |= value << (c * 8);
+            }
+            target.pixels[(size_t)y * target.width + x] = pixel;
+        }
+    }
+}
@@ -1,34 +1,142 @@
 #include "common.hpp"
 #include "launchers.hpp"
+#include "config.hpp"
+#include "crawler.hpp"
+#include "folderindex.hpp"
+#include "matchengine.hpp"
+#include "matcher.hpp"
+#include "perfreport.hpp"
+#include "spawn.hpp"
+#include "watcher.hpp"
 
 namespace fs = std::filesystem;
 
-static LauncherContext ctxVSCode;
-static LauncherContext ctxWSL;
+static std::vector<LauncherContext> launcherContexts;
 static LauncherContext* activeCtx = nullptr;
 
 static bool launcherClassRegistered = false;
-static HWND hLauncherWindow = NULL;
+// Read by the crawl, match and launch timer threads.
+static std::atomic<HWND> hLauncherWindow(NULL);
 static HWND hEdit = NULL;
-static HWND hListBox = NULL;
+static std::atomic<HWND> hResultList(NULL);
 static HWND hPathLabel = NULL;
 
 static HBRUSH hLauncherBgBrush = NULL;
 static HBRUSH hEditBgBrush = NULL;
-static HBRUSH hListBoxBgBrush = NULL;
+static HBRUSH hScrollThumbBrush = NULL;
+static HBITMAP hSelectionBitmap = NULL;
 static HFONT hGlobalFont = NULL;
 static HFONT hSmallFont = NULL;
 
+// The result list paints into one back buffer that lives as long as the
+// launcher and is only reallocated when the list changes size.
+static HDC hBackBufferDC = NULL;
+static HBITMAP hBackBuffer = NULL;
+static HGDIOBJ hBackBufferDefault = NULL;
+static int backBufferWidth = 0;
+static int backBufferHeight = 0;
+static HDC hSpriteDC = NULL;
+
 static std::string historyBaseDir = "";
+static HistoryJournal historyJournal;
+static const size_t historyCompactionInterval = 64;
+static std::string indexBaseDir = "";
 static const int maxSubFolderDepth = 5;
-static const int maxPathsN = 5;
+static const int maxPathsN = 50;
 static std::vector<std::string> crawlerRootPaths;
-static std::vector<std::string> currentMatches;
-static std::vector<std::string> allCrawledFolders;
+static std::shared_ptr<const FolderIndex> crawledIndex = std::make_shared<FolderIndex>();
 static int pendingIndex = -1;
+static int selectedIndex = -1;
+static int topIndex = 0;
+static int resultRowHeight = 1;
 
 static std::atomic<bool> isScanning(false);
-static std::mutex crawlMutex;
+static CrawlerEngine crawlerEngine(NativeFileSystem());
+static std::mutex indexWriteMutex;
+static std::unordered_map<std::string, int> crawledRootDepths;
+static std::unique_ptr<SnapshotFiles> indexSnapshots;
+static bool isSnapshotStale = false;
+static ULONGLONG lastSnapshotSaveTick = 0;
+static const ULONGLONG snapshotSaveIntervalMs = 60 * 1000;
+static std::unique_ptr<DirectoryWatcher> folderWatcher;
+static std::vector<std::string> unwatchedRoots;
+static std::thread deltaThread;
+static std::mutex deltaMutex;
+static std::condition_variable deltaCondition;
+static std::vector<std::function<void()>> deltaJobs;
+static std::atomic<bool> isDeltaStopping(false);
+static CrawlerEngine unwatchedEngine(NativeFileSystem());
+static std::atomic<ULONGLONG> lastUnwatchedCrawlTick(0);
+static const ULONGLONG unwatchedCrawlIntervalMs = 60 * 1000;
+static std::atomic<bool> isRescanNeeded(false);
+static std::atomic<ULONGLONG> lastCrawlTick(0);
+static const ULONGLONG consistencyCrawlIntervalMs = 30 * 60 * 1000;
+static std::mutex perfMutex;
+static std::thread startupThread;
+static std::atomic<bool> isStartupCancelled(false);
+static std::atomic<bool> isStartupFinished(false);
+static std::atomic<HANDLE> hStartupThread(NULL);
+static const DWORD wslListTimeoutMs = 5000;
+static std::mutex watcherMutex;
+static std::atomic<bool> areEnginesReady(false);
+static std::atomic<bool> areLogosReady(false);
+static std::atomic<bool> areRootsReady(false);
+static CrawlPerf lastCrawlPerf;
+static MatchPerf matchPerf;
+static LaunchPerf launchPerf;
+static ShowPerf showPerf;
+static std::chrono::steady_clock::time_point showStart;
+static bool isShowTimed = false;
+static bool isShowRebuilt = false;
+static std::unique_ptr<ProcessSpawner> processSpawner = CreateProcessSpawner();
+static std::thread launchTimerThread;
+static std::atomic<bool> isLaunchTimerRunning(false);
+static std::atomic<bool> isLaunchTimerStopping(false);
+static const ULONGLONG launchWindowTimeoutMs = 10000;
+
+static const float logoOpacity = 0.12f;
+
+static const UINT WM_LAUNCHER_MATCHES = WM_APP + 1;
+static const UINT WM_LAUNCHER_INDEX_UPDATED = WM_APP + 2;
+
+#ifndef WM_DPICHANGED
+#define WM_DPICHANGED 0x02E0
+#endif
+
+struct LauncherMatch {
+    bool fromHistory;
+    uint32_t id;
+};
+
+struct MatchRequest {
+    uint64_t generation = 0;
+    std::string input;
+    HWND target = NULL;
+    const LauncherModeSpec* mode = nullptr;
+    std::shared_ptr<const HistorySnapshot> history;
+};
+
+struct MatchResult {
+    uint64_t generation = 0;
+    std::string input;
+    std::shared_ptr<const HistorySnapshot> history;
+    std::shared_ptr<const FolderIndex> crawledIndex;
+    std::vector<LauncherMatch> matches;
+};
+
+static std::mutex matchMutex;
+static std::condition_variable matchCondition;
+static std::atomic<uint64_t> matchGeneration(0);
+static bool matchRequestPending = false;
+static bool matchWorkerStarted = false;
+static bool matchWorkerStopping = false;
+static MatchRequest pendingRequest;
+static MatchResult completedResult;
+
+static std::vector<LauncherMatch> currentMatches;
+static std::shared_ptr<const HistorySnapshot> matchedHistory;
+static std::shared_ptr<const FolderIndex> matchedIndex;
+static std::string shownInput;
 
 static std::string GetEnv(const std::string& var) {
     char buf[MAX_PATH];
@@ -36,20 +144,60 @@ static std::string GetEnv(const std::string& var) {
     return (res > 0 && res < MAX_PATH) ? std::string(buf) : "";
 }
 
-static void FindVSCode(LauncherContext& launcherCtx) {
-    std::vector<std::string> searchBases = {
-        GetEnv("LOCALAPPDATA") + "\\Programs\\Microsoft VS Code",
-        GetEnv("ProgramFiles") + "\\Microsoft VS Code",
-        "C:\\Program Files\\Microsoft VS Code"
-    };
-    for (const auto& base : searchBases) {
-        if (base.length() < 5) continue;
-        fs::path rootPath(base);
-        fs::path exePath = rootPath / "Code.exe";
-        fs::path cliPath = rootPath / "resources" / "app" / "out" / "cli.js";
-        if (fs::exists(exePath) && fs::exists(cliPath)) {
-            launcherCtx.executablePath = exePath.u8string();
-            launcherCtx.cliPath = cliPath.u8string();
+static std::string ExpandEnvironment(const std::string& text) {
+    char expanded[MAX_PATH];
+    DWORD length = ExpandEnvironmentStringsA(text.c_str(), expanded, MAX_PATH);
+    return (length > 0 && length <= MAX_PATH) ? std::string(expanded) : text;
+}
+
+// Adding a launcher means adding a line to the config's "launchers" list;
+// all modes share one crawl and differ only in the slice of the index they
+// offer and how they launch.
+static std::vector<LauncherModeSpec> LauncherModeRegistry() {
+    std::vector<LauncherModeSpec> registry;
+    for (const auto& launcher : Config::launchers) {
+        LauncherModeSpec spec;
+        spec.name = launcher.name;
+        spec.historyName = launcher.history;
+        spec.logo = launcher.logo;
+        spec.placeholder = launcher.placeholder;
+        spec.engineCandidates = launcher.engine;
+        for (const auto& prefix : launcher.include) spec.includePrefixes.push_back(ExpandEnvironment(prefix));
+        for (const auto& prefix : launcher.exclude) spec.excludePrefixes.push_back(ExpandEnvironment(prefix));
+        for (const auto& argument : launcher.command) {
+            size_t space = argument.find(' ');
+            if (argument[0] == '-' && space != std::string::npos) {
+                spec.command.push_back({ argument.substr(0, space), argument.substr(space + 1) });
+            } else {
+                spec.command.push_back({ "", argument });
+            }
+        }
+        for (const auto& variable : launcher.environment) {
+            size_t equals = variable.find('=');
+            if (equals == std::string::npos) continue;
+            spec.environment.push_back({ variable.substr(0, equals), variable.substr(equals + 1) });
+        }
+        registry.push_back(std::move(spec));
+    }
+    return registry;
+}
+
+static void FindEngine(LauncherContext& launcherCtx) {
+    for (const auto& candidate : launcherCtx.spec.engineCandidates) {
+        char pathBuf[MAX_PATH];
+        if (candidate.find_first_of("\\/") == std::string::npos) {
+            if (SearchPathA(NULL, candidate.c_str(), NULL, MAX_PATH, pathBuf, NULL) > 0) {
+                launcherCtx.executablePath = std::string(pathBuf);
+                launcherCtx.isEngineFound = true;
+                return;
+            }
+            continue;
+        }
+        DWORD length = ExpandEnvironmentStringsA(candidate.c_str(), pathBuf, MAX_PATH);
+        if (length == 0 || length > MAX_PATH) continue;
+        std::error_code ec;
+        if (fs::exists(pathBuf, ec)) {
+            launcherCtx.executablePath = std::string(pathBuf);
             launcherCtx.isEngineFound = true;
             return;
         }
@@ -57,14 +205,11 @@ static void FindVSCode(LauncherContext& launcherCtx) {
     launcherCtx.isEngineFound = false;
 }
 
-static void FindWSL(LauncherContext& launcherCtx) {
-    char pathBuf[MAX_PATH];
-    if (SearchPathA(NULL, "wsl", ".exe", MAX_PATH, pathBuf, NULL) > 0) {
-        launcherCtx.executablePath = std::string(pathBuf);
-        launcherCtx.isEngineFound = true;
-        return;
+static LauncherContext* FindLauncherContext(const std::string& name) {
+    for (auto& ctx : launcherContexts) {
+        if (ctx.spec.name == name) return &ctx;
     }
-    launcherCtx.isEngineFound = false;
+    return nullptr;
 }
 
 static void SetUpStoragePath() {
@@ -72,41 +217,43 @@ static void SetUpStoragePath() {
     if (!baseAppPath.empty()) {
         std::string kinesisPath = baseAppPath + "\\Kinesis";
         std::string historyPath = kinesisPath + "\\History";
+        std::string indexPath = kinesisPath + "\\Index";
         CreateDirectoryA(kinesisPath.c_str(), NULL);
         CreateDirectoryA(historyPath.c_str(), NULL);
+        CreateDirectoryA(indexPath.c_str(), NULL);
         historyBaseDir = historyPath;
+        indexBaseDir = indexPath;
     }
 }
 
-static void LoadHistory(LauncherContext& ctx) {
-    std::string fullPath = historyBaseDir + "\\" + ctx.historyFileName;
-    std::ifstream file(fullPath);
-    if (file.is_open()) {
-        ctx.history.clear();
-        std::string line;
-        while (std::getline(file, line)) if (!line.empty()) ctx.history.push_back(line);
-    }
+static int64_t CurrentUnixTime() {
+    return (int64_t)std::time(nullptr);
 }
 
-static void SaveHistory(const LauncherContext& ctx) {
-    std::string fullPath = historyBaseDir + "\\" + ctx.historyFileName;
-    std::ofstream file(fullPath, std::ios::trunc);
-    if (file.is_open()) {
-        for (const auto& entry : ctx.history) file << entry << "\n";
-    }
+static void RebuildHistorySnapshot(LauncherContext& ctx) {
+    ctx.historySnapshot = BuildHistorySnapshot(ctx.history, CurrentUnixTime());
+}
+
+static void CompactHistory(LauncherContext& ctx) {
+    historyJournal.Compact(historyBaseDir + "\\" + ctx.historyFileName,
+                           historyBaseDir + "\\" + ctx.journalFileName, ctx.history);
+    ctx.journalEvents = 0;
+}
+
+// The in-memory store is authoritative after this; disk is only written
+// by the journal thread.
+static void LoadHistory(LauncherContext& ctx) {
+    ctx.history.Load(historyBaseDir + "\\" + ctx.historyFileName, CurrentUnixTime());
+    if (ctx.history.Replay(historyBaseDir + "\\" + ctx.journalFileName) > 0) CompactHistory(ctx);
+    RebuildHistorySnapshot(ctx);
 }
 
 static void AddToHistory(const std::string& newPath) {
-    auto& history = activeCtx->history;
-    auto it = std::find(history.begin(), history.end(), newPath);
-    if (it != history.end()) {
-        history.erase(it);
-    }
-    history.insert(history.begin(), newPath);
-    if (history.size() > 50) {
-        history.pop_back();
-    }
-    SaveHistory(*activeCtx);
+    int64_t now = CurrentUnixTime();
+    uint64_t sequence = activeCtx->history.Record(newPath, now);
+    RebuildHistorySnapshot(*activeCtx);
+    historyJournal.Append(historyBaseDir + "\\" + activeCtx->journalFileName, sequence, newPath, now);
+    if (++activeCtx->journalEvents >= historyCompactionInterval) CompactHistory(*activeCtx);
 }
 
 static const std::vector<std::string> GetOneDrivePaths() {
@@ -169,12 +316,27 @@ static std::vector<std::string> GetWSLDistros() {
     char cmd[] = "wsl.exe -l -q";
     if (CreateProcessA(NULL, cmd, NULL, NULL, TRUE, CREATE_NO_WINDOW, NULL, NULL, &si, &pi)) {
         CloseHandle(hWrite);
-        
+
+        // wsl.exe can hang while the WSL service starts, so the pipe is
+        // only read when data is waiting and the wait gives up on timeout
+        // or when the launcher is shutting down.
         std::vector<char> rawBuffer;
         char chunk[1024];
         DWORD bytesRead;
-        while (ReadFile(hRead, chunk, sizeof(chunk), &bytesRead, NULL) && bytesRead > 0) {
-            rawBuffer.insert(rawBuffer.end(), chunk, chunk + bytesRead);
+        DWORD bytesAvailable;
+        ULONGLONG deadline = GetTickCount64() + wslListTimeoutMs;
+        bool isExited = false;
+        while (!isExited) {
+            isExited = WaitForSingleObject(pi.hProcess, 50) == WAIT_OBJECT_0;
+            while (PeekNamedPipe(hRead, NULL, 0, NULL, &bytesAvailable, NULL) && bytesAvailable > 0 &&
+                   ReadFile(hRead, chunk, sizeof(chunk), &bytesRead, NULL) && bytesRead > 0) {
+                rawBuffer.insert(rawBuffer.end(), chunk, chunk + bytesRead);
+            }
+            if (!isExited && (isStartupCancelled || GetTickCount64() >= deadline)) {
+                TerminateProcess(pi.hProcess, 1);
+                rawBuffer.clear();
+                break;
+            }
         }
 
         std::string currentDistro;
@@ -214,18 +376,31 @@ static void InitializeCrawlerRootPaths() {
         }
     }
 
+    for (const auto& root : Config::crawlerRoots) {
+        std::string path = ExpandEnvironment(root);
+        while (path.size() > 3 && (path.back() == '\\' || path.back() == '/')) path.pop_back();
+        if (std::find(crawlerRootPaths.begin(), crawlerRootPaths.end(), path) == crawlerRootPaths.end()) {
+            crawlerRootPaths.push_back(path);
+        }
+    }
+
     std::vector<std::string> distros = GetWSLDistros();
     std::error_code ec;
     for (const std::string& distro : distros) {
+        if (isStartupCancelled) return;
         std::string basePaths[] = { 
             "\\\\wsl.localhost\\" + distro + "\\home",
             "\\\\wsl$\\" + distro + "\\home" 
         };
         for (const std::string& homeBase : basePaths) {
             if (fs::exists(homeBase, ec)) {
-                for (auto const& userEntry : fs::directory_iterator(homeBase, ec)) {
-                    if (!ec && userEntry.is_directory(ec)) {
-                        crawlerRootPaths.push_back(userEntry.path().string());
+                // Stepped with error codes, since a cancelled listing must
+                // end the loop rather than throw.
+                for (fs::directory_iterator it(homeBase, ec), end; !ec && it != end && !isStartupCancelled;
+                     it.increment(ec)) {
+                    std::error_code typeError;
+                    if (it->is_directory(typeError)) {
+                        crawlerRootPaths.push_back(it->path().string());
                     }
                 }
                 break;
@@ -234,52 +409,546 @@ static void InitializeCrawlerRootPaths() {
     }
 }
 
-static void ScanDirectory(const std::string& path, std::vector<std::string>& results, int depth) {
-    if (depth > maxSubFolderDepth) return;
+static void LoadIndexSnapshot() {
+    if (indexBaseDir.empty()) return;
+    indexSnapshots = std::make_unique<SnapshotFiles>(indexBaseDir, "folders");
+    auto snapshot = std::make_shared<FolderIndex>();
+    if (indexSnapshots->LoadNewest(*snapshot)) {
+        std::shared_ptr<const FolderIndex> loaded = std::move(snapshot);
+        std::atomic_store(&crawledIndex, loaded);
+    }
+}
 
-    WIN32_FIND_DATAA fd;
-    HANDLE hFind = FindFirstFileA((path + "\\*").c_str(), &fd);
-    if (hFind != INVALID_HANDLE_VALUE) {
-        do {
-            if (!(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) || (fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)) {
-                continue;
-            }
-            if ((fd.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN) ||
-                (fd.dwFileAttributes & FILE_ATTRIBUTE_SYSTEM) ||
-                (fd.dwFileAttributes & FILE_ATTRIBUTE_OFFLINE)) {
-                continue;
+// Called with indexWriteMutex held. A failed save leaves the previous
+// generation on disk and is retried on exit.
+static void SaveIndexSnapshot(const FolderIndex& index) {
+    if (!indexSnapshots) return;
+    isSnapshotStale = !indexSnapshots->Save(index);
+    if (!isSnapshotStale) lastSnapshotSaveTick = GetTickCount64();
+}
+
+// Deltas come in bursts, so they save at most once a minute and otherwise
+// leave the snapshot stale for the next save or for exit.
+static void SaveIndexSnapshotThrottled(const FolderIndex& index) {
+    if (GetTickCount64() - lastSnapshotSaveTick >= snapshotSaveIntervalMs) SaveIndexSnapshot(index);
+    else isSnapshotStale = true;
+}
+
+static void SavePerfSnapshot() {
+    CrawlPerf crawl;
+    MatchPerf match;
+    LaunchPerf launch;
+    ShowPerf show;
+    {
+        std::lock_guard<std::mutex> lock(perfMutex);
+        crawl = lastCrawlPerf;
+        match = matchPerf;
+        launch = launchPerf;
+        show = showPerf;
+    }
+    SavePerfReport(indexBaseDir + "\\perf_report.json", crawl, match, launch, show);
+}
+
+static std::shared_ptr<const FolderIndex> CurrentCrawledIndex() {
+    return std::atomic_load(&crawledIndex);
+}
+
+// Writers hold indexWriteMutex, so a crawl and a batch of watcher deltas
+// never publish over each other. Readers only use CurrentCrawledIndex().
+static void PublishCrawledIndex(std::shared_ptr<const FolderIndex> index) {
+    std::atomic_store(&crawledIndex, std::move(index));
+    HWND target = hLauncherWindow;
+    if (target) PostMessage(target, WM_LAUNCHER_INDEX_UPDATED, 0, 0);
+}
+
+static bool IsPathUnder(const std::string& path, const std::string& folder) {
+    if (path.size() < folder.size() || path.compare(0, folder.size(), folder) != 0) return false;
+    return path.size() == folder.size() || path[folder.size()] == '\\' || folder.back() == '\\';
+}
+
+// The current folders minus everything under a removed folder, plus added.
+// A removed folder and its subtree are two id ranges of the sorted index,
+// so the new index is merged from the current one in a single pass.
+static std::shared_ptr<const FolderIndex> ReplaceFolders(const FolderIndex& current, const std::vector<std::string>& removed,
+                                                         const std::vector<std::string>& added) {
+    std::vector<IdRange> removedRanges;
+    for (const auto& folder : removed) {
+        if (folder.empty()) continue;
+        IdRange self = current.PrefixRange(folder);
+        if (self.begin < self.end && current.Path(self.begin) == folder) removedRanges.push_back({ self.begin, self.begin + 1 });
+        removedRanges.push_back(current.PrefixRange(folder.back() == '\\' ? folder : folder + '\\'));
+    }
+
+    auto updatedIndex = std::make_shared<FolderIndex>();
+    updatedIndex->BuildReplaced(current, std::move(removedRanges), added);
+    return updatedIndex;
+}
+
+// CrawlPart is one finished root of a full crawl, which saves once at the
+// end. A Delta comes from the watcher or a polled root; it is saved, and
+// while a full crawl runs it is also kept for replay on top of the crawl's
+// result, which may have listed those folders before they changed.
+enum class FolderPublish {
+    CrawlPart,
+    Delta
+};
+
+struct FolderDelta {
+    std::vector<std::string> removed;
+    std::vector<std::string> added;
+};
+
+// Both guarded by indexWriteMutex.
+static bool isRecordingDeltas = false;
+static std::vector<FolderDelta> crawlDeltas;
+
+// Rebuilds without indexWriteMutex, so a large index does not hold up
+// crawls and other writers. If someone published in the meantime the
+// rebuild is redone on top of their index.
+static void PublishReplacedFolders(const std::vector<std::string>& removed, const std::vector<std::string>& added,
+                                   FolderPublish kind) {
+    while (true) {
+        std::shared_ptr<const FolderIndex> current = CurrentCrawledIndex();
+        std::shared_ptr<const FolderIndex> updatedIndex = ReplaceFolders(*current, removed, added);
+        std::lock_guard<std::mutex> lock(indexWriteMutex);
+        if (CurrentCrawledIndex() != current) continue;
+        PublishCrawledIndex(updatedIndex);
+        if (kind == FolderPublish::Delta) {
+            SaveIndexSnapshotThrottled(*updatedIndex);
+            if (isRecordingDeltas) crawlDeltas.push_back({ removed, added });
+        }
+        return;
+    }
+}
+
+// Collects folders while a cold crawl is running and republishes them each
+// time the set doubles, so the first results show up after a few hundred
+// folders while the total rebuild cost stays linear. The crawler calls
+// Append with its batch lock held, so batches are only queued there and the
+// partial indexes are built on a thread of their own.
+class CrawlStream {
+public:
+    void Start() {
+        builder = std::thread([this] { Run(); });
+    }
+
+    // A finished root is published right away, whatever the set's size.
+    void Append(const std::vector<std::string>& batch, bool isRootDone = false) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        pending.insert(pending.end(), batch.begin(), batch.end());
+        isPublishDue = isPublishDue || isRootDone;
+        queueCondition.notify_one();
+    }
+
+    // Waits for a build in progress, so no partial index is published over
+    // the crawl's final one.
+    void Finish() {
+        if (!builder.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            isFinished = true;
+        }
+        queueCondition.notify_one();
+        builder.join();
+    }
+
+private:
+    void Run() {
+        std::vector<std::string> batch;
+        while (true) {
+            bool isDue = false;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueCondition.wait(lock, [this] { return isFinished || !pending.empty(); });
+                if (isFinished) return;
+                batch.swap(pending);
+                isDue = isPublishDue;
+                isPublishDue = false;
             }
-            if (strcmp(fd.cFileName, ".") == 0 || strcmp(fd.cFileName, "..") == 0) {
-                continue;
+            for (auto& path : batch) {
+                if (seen.insert(path).second) folders.push_back(std::move(path));
             }
-            if (strcmp(fd.cFileName, "node_modules") == 0 ||
-                strcmp(fd.cFileName, ".git") == 0 ||
-                strcmp(fd.cFileName, "bin") == 0 ||
-                strcmp(fd.cFileName, ".vs") == 0 ||
-                strcmp(fd.cFileName, "obj") == 0) {
-                    continue;
+            batch.clear();
+            if (folders.size() == published || (!isDue && folders.size() < std::max<size_t>(published * 2, 1))) continue;
+            auto partialIndex = std::make_shared<FolderIndex>();
+            partialIndex->Build(folders);
+            published = folders.size();
+            std::lock_guard<std::mutex> lock(indexWriteMutex);
+            PublishCrawledIndex(std::move(partialIndex));
+        }
+    }
+
+    std::thread builder;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::vector<std::string> pending;
+    bool isPublishDue = false;
+    bool isFinished = false;
+    std::vector<std::string> folders;
+    std::unordered_set<std::string> seen;
+    size_t published = 0;
+};
+
+// Replaces the folders of each root a warm crawl has finished. Each
+// replacement rebuilds the whole index, so roots that finish while one is
+// being built are gathered and replaced together by the next, and the
+// rebuilds cost at most one per build time instead of one per root.
+class RootReplacer {
+public:
+    void Start() {
+        builder = std::thread([this] { Run(); });
+    }
+
+    void Append(const std::string& root, const std::vector<std::string>& folders) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        roots.push_back(root);
+        pending.insert(pending.end(), folders.begin(), folders.end());
+        queueCondition.notify_one();
+    }
+
+    // Waits for a replacement in progress, so none is published over the
+    // crawl's final index. Roots still queued are dropped, since that index
+    // replaces everything anyway.
+    void Finish() {
+        if (!builder.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            isFinished = true;
+        }
+        queueCondition.notify_one();
+        builder.join();
+    }
+
+private:
+    void Run() {
+        std::vector<std::string> batchRoots;
+        std::vector<std::string> batch;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueCondition.wait(lock, [this] { return isFinished || !roots.empty(); });
+                if (isFinished) return;
+                batchRoots.swap(roots);
+                batch.swap(pending);
             }
-            std::string fullPath = path + "\\" + fd.cFileName;
-            results.push_back(fullPath);
-            ScanDirectory(fullPath, results, depth + 1);
-        } while (FindNextFileA(hFind, &fd));
-        FindClose(hFind);
+            PublishReplacedFolders(batchRoots, batch, FolderPublish::CrawlPart);
+            batchRoots.clear();
+            batch.clear();
+        }
     }
-}
+
+    std::thread builder;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::vector<std::string> roots;
+    std::vector<std::string> pending;
+    bool isFinished = false;
+};
 
 static void BackgroundCrawl() {
     if (isScanning.exchange(true)) return;
-    std::thread([]() {
-        std::vector<std::string> tempFolders;
-        for (const auto& root : crawlerRootPaths) ScanDirectory(root, tempFolders, 0);
+    lastCrawlTick = GetTickCount64();
+    lastUnwatchedCrawlTick = lastCrawlTick.load();
+    isRescanNeeded = false;
+    auto excludes = std::make_shared<ExcludeRules>();
+    excludes->Compile(Config::crawlerExcludes);
+    CrawlOptions options;
+    options.maxDepth = maxSubFolderDepth;
+    options.stopAtProjects = Config::projectRootCrawl;
+    options.projectDepth = Config::projectSubFolderDepth;
+    options.excludes = excludes.get();
+
+    std::thread([options, excludes]() mutable {
         {
-            std::lock_guard<std::mutex> lock(crawlMutex);
-            allCrawledFolders.swap(tempFolders);
+            std::lock_guard<std::mutex> lock(indexWriteMutex);
+            isRecordingDeltas = true;
+            crawlDeltas.clear();
         }
+        // A loaded or previous index is never streamed over, since partial
+        // batches would only shrink the list; instead finished roots replace
+        // their own part of it while slower roots keep crawling.
+        CrawlStream stream;
+        RootReplacer replacer;
+        if (CurrentCrawledIndex()->Empty()) {
+            stream.Start();
+            options.onBatch = [&stream](const std::vector<std::string>& batch) { stream.Append(batch); };
+            options.onRootDone = [&stream](const CrawlRootStats&, const std::vector<std::string>& folders) {
+                stream.Append(folders, true);
+            };
+        } else {
+            replacer.Start();
+            options.onRootDone = [&replacer](const CrawlRootStats& stats, const std::vector<std::string>& folders) {
+                replacer.Append(stats.root, folders);
+            };
+        }
+        auto crawlStart = std::chrono::steady_clock::now();
+        CrawlResult crawl = crawlerEngine.Crawl(crawlerRootPaths, options);
+        stream.Finish();
+        replacer.Finish();
+        auto buildStart = std::chrono::steady_clock::now();
+
+        auto freshIndex = std::make_shared<FolderIndex>();
+        freshIndex->Build(crawl.folders);
+
+        CrawlPerf crawlPerf;
+        crawlPerf.wallMs = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(buildStart - crawlStart).count();
+        crawlPerf.buildMs = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - buildStart).count();
+        crawlPerf.directories = crawl.folders.size();
+        crawlPerf.directoriesPerSecond = crawlPerf.directories * 1000.0 / std::max<uint64_t>(crawlPerf.wallMs, 1);
+        crawlPerf.indexBytes = freshIndex->ByteSize();
+        crawlPerf.roots = std::move(crawl.stats);
+        {
+            std::lock_guard<std::mutex> perfLock(perfMutex);
+            lastCrawlPerf = crawlPerf;
+        }
+
+        // Deltas are replayed off the lock in the order they were published;
+        // any that arrive meanwhile are picked up by the next round.
+        std::shared_ptr<const FolderIndex> finalIndex = std::move(freshIndex);
+        std::unique_lock<std::mutex> lock(indexWriteMutex);
+        while (!crawlDeltas.empty()) {
+            std::vector<FolderDelta> deltas;
+            deltas.swap(crawlDeltas);
+            lock.unlock();
+            for (const auto& delta : deltas) finalIndex = ReplaceFolders(*finalIndex, delta.removed, delta.added);
+            lock.lock();
+        }
+        isRecordingDeltas = false;
+        for (const auto& stat : crawlPerf.roots) crawledRootDepths[stat.root] = stat.depth;
         isScanning = false;
+        PublishCrawledIndex(finalIndex);
+        if (!indexBaseDir.empty()) {
+            SaveIndexSnapshot(*finalIndex);
+            SavePerfSnapshot();
+        }
     }).detach();
 }
 
+static bool IsProjectFolder(const std::string& path) {
+    CrawlListing listing;
+    NativeFileSystem().ListDirectory(path, listing);
+    return listing.isProject;
+}
+
+// How much of an added folder a full crawl would have indexed: the folder
+// itself only when isIndexed, then depth levels below it (none when
+// negative). Inside a project the project rule already applies, so nested
+// projects no longer stop the crawl.
+struct AddedFolderScope {
+    bool isIndexed = false;
+    int depth = -1;
+    bool stopAtProjects = false;
+};
+
+// Mirrors the crawler's depth and project rules for a folder reported by
+// the watcher, so deltas add only what a full crawl would have indexed.
+static AddedFolderScope ScopeAddedFolder(const std::string& path, const std::unordered_map<std::string, int>& rootDepths,
+                                         bool stopAtProjects, int projectDepth) {
+    AddedFolderScope scope;
+    const std::string* root = nullptr;
+    for (const auto& candidate : crawlerRootPaths) {
+        if (candidate != path && IsPathUnder(path, candidate) && (!root || candidate.size() > root->size())) {
+            root = &candidate;
+        }
+    }
+    if (!root) return scope;
+
+    std::vector<std::string> ancestors { *root };
+    for (size_t pos = root->size() + 1; (pos = path.find('\\', pos)) != std::string::npos; ++pos) {
+        ancestors.push_back(path.substr(0, pos));
+    }
+    auto depth = rootDepths.find(*root);
+    int maxDepth = depth != rootDepths.end() ? depth->second : maxSubFolderDepth;
+    int level = (int)ancestors.size();
+    if (level > maxDepth + 1) return scope;
+
+    // Depth 0 of a crawl lists the folder's own children.
+    scope.isIndexed = true;
+    scope.depth = maxDepth - level;
+    scope.stopAtProjects = stopAtProjects;
+    if (stopAtProjects) {
+        for (size_t i = 0; i < ancestors.size(); ++i) {
+            if (!IsProjectFolder(ancestors[i])) continue;
+            int distance = level - (int)i;
+            scope.isIndexed = distance <= projectDepth;
+            scope.depth = std::min<int>(scope.depth, projectDepth - distance - 1);
+            scope.stopAtProjects = false;
+            break;
+        }
+    }
+    return scope;
+}
+
+// A folder renamed or moved into a root arrives as one Added event, so its
+// subtree is crawled here. The folder itself goes through the same filter
+// as a listed one, since a hidden or system folder, or a reparse point,
+// would never have been reached by a crawl. The crawl uses a throwaway
+// engine, because the shared one drops its cached records for every root it
+// is not given, and stops early when the watcher is stopped.
+static void CollectAddedSubtree(const std::string& path, const AddedFolderScope& scope, const ExcludeRules& excludes,
+                                int projectDepth, std::vector<std::string>& folders) {
+    if (!NativeFileSystem().IsListedFolder(path)) return;
+    folders.push_back(path);
+    if (scope.depth < 0) return;
+    CrawlOptions options;
+    options.maxDepth = scope.depth;
+    options.minDepth = scope.depth;
+    options.maxAdaptiveDepth = scope.depth;
+    options.stopAtProjects = scope.stopAtProjects;
+    options.projectDepth = projectDepth;
+    options.excludes = &excludes;
+    options.isCancelled = [] { return isDeltaStopping.load(); };
+    CrawlerEngine subtreeEngine(NativeFileSystem());
+    CrawlResult crawl = subtreeEngine.Crawl({ path }, options);
+    folders.insert(folders.end(), std::make_move_iterator(crawl.folders.begin()), std::make_move_iterator(crawl.folders.end()));
+}
+
+// Runs on the delta worker. Nothing here holds indexWriteMutex except the
+// final publish.
+static void ApplyFolderEvents(const std::vector<FolderEvent>& events, const ExcludeRules& excludes, bool stopAtProjects,
+                              int projectDepth) {
+    std::vector<std::string> added;
+    std::vector<std::string> removed;
+    for (const auto& event : events) {
+        if (event.change == FolderChange::Overflow) {
+            isRescanNeeded = true;
+        } else if (event.change == FolderChange::Added) {
+            added.push_back(event.path);
+        } else {
+            added.erase(std::remove_if(added.begin(), added.end(), [&](const std::string& path) {
+                return IsPathUnder(path, event.path);
+            }), added.end());
+            removed.push_back(event.path);
+        }
+    }
+    if (added.empty() && removed.empty()) return;
+
+    std::unordered_map<std::string, int> rootDepths;
+    {
+        std::lock_guard<std::mutex> lock(indexWriteMutex);
+        rootDepths = crawledRootDepths;
+    }
+
+    // A folder below another added folder is covered by that one's crawl.
+    std::vector<std::string> folders;
+    for (const auto& path : added) {
+        bool isCovered = false;
+        for (const auto& other : added) {
+            if (other != path && IsPathUnder(path, other)) {
+                isCovered = true;
+                break;
+            }
+        }
+        if (isCovered) continue;
+        AddedFolderScope scope = ScopeAddedFolder(path, rootDepths, stopAtProjects, projectDepth);
+        if (scope.isIndexed) CollectAddedSubtree(path, scope, excludes, projectDepth, folders);
+    }
+    if (isDeltaStopping || (folders.empty() && removed.empty())) return;
+    PublishReplacedFolders(removed, folders, FolderPublish::Delta);
+}
+
+// Subtree crawls and polled roots run on this one thread rather than the
+// watcher's, so the watcher only queues events and stopping it never waits
+// for a crawl. Jobs run in the order they were queued.
+static void DeltaWorkerLoop() {
+    std::vector<std::function<void()>> jobs;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(deltaMutex);
+            deltaCondition.wait(lock, [] { return isDeltaStopping || !deltaJobs.empty(); });
+            if (isDeltaStopping) return;
+            jobs.swap(deltaJobs);
+        }
+        for (auto& job : jobs) {
+            if (isDeltaStopping) return;
+            job();
+        }
+        jobs.clear();
+    }
+}
+
+// Jobs queued while the worker is not running are dropped.
+static void QueueDeltaJob(std::function<void()> job) {
+    std::lock_guard<std::mutex> lock(deltaMutex);
+    if (!deltaThread.joinable() || isDeltaStopping) return;
+    deltaJobs.push_back(std::move(job));
+    deltaCondition.notify_one();
+}
+
+static void StartFolderWatcher() {
+    auto excludes = std::make_shared<ExcludeRules>();
+    excludes->Compile(Config::crawlerExcludes);
+    bool stopAtProjects = Config::projectRootCrawl;
+    int projectDepth = Config::projectSubFolderDepth;
+
+    std::lock_guard<std::mutex> lock(watcherMutex);
+    if (isStartupCancelled) return;
+    {
+        std::lock_guard<std::mutex> deltaLock(deltaMutex);
+        isDeltaStopping = false;
+        if (!deltaThread.joinable()) deltaThread = std::thread(DeltaWorkerLoop);
+    }
+    folderWatcher = CreateDirectoryWatcher();
+    folderWatcher->Start(crawlerRootPaths, *excludes, [=](const std::vector<FolderEvent>& events) {
+        QueueDeltaJob([=] { ApplyFolderEvents(events, *excludes, stopAtProjects, projectDepth); });
+    });
+    unwatchedRoots = folderWatcher->UnwatchedRoots();
+}
+
+// The stop flag cancels a subtree or polled crawl in progress, so joining
+// the delta worker takes at most one directory listing per crawl worker.
+static void StopFolderWatcher() {
+    std::lock_guard<std::mutex> lock(watcherMutex);
+    if (folderWatcher) folderWatcher->Stop();
+    folderWatcher.reset();
+    unwatchedRoots.clear();
+    {
+        std::lock_guard<std::mutex> deltaLock(deltaMutex);
+        isDeltaStopping = true;
+        deltaJobs.clear();
+    }
+    deltaCondition.notify_one();
+    if (deltaThread.joinable()) deltaThread.join();
+}
+
+// With live deltas the full crawl is only a consistency check: it runs
+// after a watcher overflow or every half hour. Before startup has
+// discovered the roots the pipeline owns the first crawl.
+static bool IsConsistencyCrawlDue() {
+    if (!areRootsReady) return false;
+    return isRescanNeeded || GetTickCount64() - lastCrawlTick >= consistencyCrawlIntervalMs;
+}
+
+// Roots the watcher cannot follow, such as WSL shares, are recrawled on
+// show instead, at most once a minute, on the delta worker. They get an
+// engine of their own so the full crawl's cached records for the other
+// roots stay in place, and a full crawl running at the same time replays
+// the result like any other delta.
+static void CrawlUnwatchedRoots() {
+    if (!areRootsReady || GetTickCount64() - lastUnwatchedCrawlTick < unwatchedCrawlIntervalMs) return;
+    std::vector<std::string> roots;
+    {
+        std::lock_guard<std::mutex> lock(watcherMutex);
+        roots = unwatchedRoots;
+    }
+    if (roots.empty()) return;
+    lastUnwatchedCrawlTick = GetTickCount64();
+    auto excludes = std::make_shared<ExcludeRules>();
+    excludes->Compile(Config::crawlerExcludes);
+    CrawlOptions options;
+    options.maxDepth = maxSubFolderDepth;
+    options.stopAtProjects = Config::projectRootCrawl;
+    options.projectDepth = Config::projectSubFolderDepth;
+    options.excludes = excludes.get();
+    options.isCancelled = [] { return isDeltaStopping.load(); };
+
+    QueueDeltaJob([roots, options, excludes]() {
+        CrawlResult crawl = unwatchedEngine.Crawl(roots, options);
+        if (!crawl.cancelled) PublishReplacedFolders(roots, crawl.folders, FolderPublish::Delta);
+    });
+}
+
 static std::string ExtractDistroFromPath(const std::string& path) {
     std::string distroName = "";
     std::string prefix = "\\\\wsl.localhost\\";
@@ -403,116 +1072,617 @@ static bool LaunchDeElevated(const std::string& path, const std::string& args, b
     return SUCCEEDED(hr);
 }
 
+static std::string MatchPath(const LauncherMatch& match) {
+    if (match.fromHistory) return matchedHistory->paths[match.id];
+    return matchedIndex->Path(match.id);
+}
+
+static bool IsLaunchedWindow(HWND hwnd, const std::string& executable, const FILETIME& launchTime) {
+    DWORD processId = 0;
+    GetWindowThreadProcessId(hwnd, &processId);
+    HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+    if (!hProcess) return false;
+
+    char image[MAX_PATH];
+    DWORD imageSize = MAX_PATH;
+    bool isLaunched = QueryFullProcessImageNameA(hProcess, 0, image, &imageSize) && _stricmp(image, executable.c_str()) == 0;
+    FILETIME created, exited, kernel, user;
+    if (!isLaunched && GetProcessTimes(hProcess, &created, &exited, &kernel, &user)) {
+        isLaunched = CompareFileTime(&created, &launchTime) >= 0;
+    }
+    CloseHandle(hProcess);
+    return isLaunched;
+}
+
+// Everything the launch timer compares against, taken when Enter is pressed
+// and before the process is spawned.
+struct LaunchStart {
+    std::chrono::steady_clock::time_point enterTime;
+    FILETIME launchTime;
+    std::vector<HWND> windows;
+};
+
+static BOOL CALLBACK CollectTopLevelWindow(HWND hwnd, LPARAM lParam) {
+    ((std::vector<HWND>*)lParam)->push_back(hwnd);
+    return TRUE;
+}
+
+static LaunchStart CaptureLaunchStart() {
+    LaunchStart start;
+    start.enterTime = std::chrono::steady_clock::now();
+    GetSystemTimeAsFileTime(&start.launchTime);
+    EnumWindows(CollectTopLevelWindow, (LPARAM)&start.windows);
+    std::sort(start.windows.begin(), start.windows.end());
+    return start;
+}
+
+// A running VS Code opens the folder from its existing process, and WSL
+// shows up in a freshly started console host, so the window counts when it
+// belongs to the executable or to any process started after Enter. Only a
+// window that did not exist at Enter counts, so an editor window that just
+// gets its focus back once the launcher hides is not taken for the launch.
+static void TimeLaunchWindow(std::string executable, LaunchStart start) {
+    ULONGLONG deadline = GetTickCount64() + launchWindowTimeoutMs;
+
+    while (!isLaunchTimerStopping && GetTickCount64() < deadline) {
+        HWND hForeground = GetForegroundWindow();
+        if (hForeground && IsWindowVisible(hForeground) &&
+            !std::binary_search(start.windows.begin(), start.windows.end(), hForeground) &&
+            IsLaunchedWindow(hForeground, executable, start.launchTime)) {
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start.enterTime;
+            std::lock_guard<std::mutex> lock(perfMutex);
+            launchPerf.Record(elapsed.count());
+            isLaunchTimerRunning = false;
+            return;
+        }
+        Sleep(15);
+    }
+    if (!isLaunchTimerStopping) {
+        std::lock_guard<std::mutex> lock(perfMutex);
+        launchPerf.timeouts++;
+    }
+    isLaunchTimerRunning = false;
+}
+
+static void StartLaunchTimer(const std::string& executable, LaunchStart start) {
+    if (isLaunchTimerRunning.exchange(true)) return;
+    if (launchTimerThread.joinable()) launchTimerThread.join();
+    launchTimerThread = std::thread(TimeLaunchWindow, executable, std::move(start));
+}
+
+static void StopLaunchTimer() {
+    isLaunchTimerStopping = true;
+    if (launchTimerThread.joinable()) launchTimerThread.join();
+}
+
+static std::string ExpandLaunchArgument(const std::string& value, const std::string& path,
+                                        const std::string& distro, const std::string& wslPath) {
+    std::string expanded;
+    for (size_t i = 0; i < value.size();) {
+        if (value.compare(i, 6, "{path}") == 0) {
+            expanded += path;
+            i += 6;
+        } else if (value.compare(i, 9, "{wslPath}") == 0) {
+            expanded += wslPath;
+            i += 9;
+        } else if (value.compare(i, 8, "{distro}") == 0) {
+            expanded += distro;
+            i += 8;
+        } else {
+            expanded += value[i++];
+        }
+    }
+    return expanded;
+}
+
 static void ExecuteLaunch(int selected) {
-    std::string path = currentMatches[selected];
+    LaunchStart start = CaptureLaunchStart();
+    std::string path = MatchPath(currentMatches[selected]);
     AddToHistory(path);
 
-    if (activeCtx->type == LauncherMode::VSCode) {
-        std::string fullArgs =
-            "/c \"set ELECTRON_RUN_AS_NODE=1 && \"" + 
-            activeCtx->executablePath + "\" \"" + 
-            activeCtx->cliPath + "\" \"" + path + "\"\"";
-        LaunchDeElevated("cmd.exe", fullArgs, true);        
-    
-    } else if (activeCtx->type == LauncherMode::WSL) {
-        std::string distroName = ExtractDistroFromPath(path);
-        std::string linuxPath = ResolveWSLPath(path, distroName);
-        std::string wslArgs = "";
-        if (!distroName.empty()) wslArgs += "-d " + distroName + " ";
-        wslArgs += "--cd \"" + linuxPath + "\"";
-        LaunchDeElevated("wsl.exe", wslArgs, false);
+    SpawnRequest request;
+    request.executable = activeCtx->executablePath;
+    request.environment = activeCtx->spec.environment;
+    std::string distroName = ExtractDistroFromPath(path);
+    std::string wslPath = ResolveWSLPath(path, distroName);
+    for (const auto& argument : activeCtx->spec.command) {
+        std::string value = ExpandLaunchArgument(argument.value, path, distroName, wslPath);
+        if (value.empty()) continue;
+        if (!argument.flag.empty()) request.arguments.push_back(argument.flag);
+        request.arguments.push_back(value);
     }
-}
 
-static void RefreshMatches(std::string input) {
-    if (!activeCtx->isEngineFound) {
-        SendMessage(hListBox, LB_RESETCONTENT, 0, 0);
-        SetWindowTextA(hPathLabel, "ERROR: executable not found! Check your installation.");
+    if (processSpawner->Spawn(request) == 0 &&
+        !LaunchDeElevated(request.executable, JoinWindowsArguments(request.arguments), false)) {
         return;
     }
+    StartLaunchTimer(request.executable, std::move(start));
+}
 
-    currentMatches.clear();
-    SendMessage(hListBox, LB_RESETCONTENT, 0, 0);
+// A mode's view is its include ranges minus its exclude ranges. Both are
+// found by binary search, so no mode ever copies the shared index.
+static std::vector<IdRange> BuildModeView(const FolderIndex& index, const LauncherModeSpec& spec) {
+    std::vector<IdRange> view;
+    if (spec.includePrefixes.empty()) view.push_back({ 0, (uint32_t)index.Size() });
+    for (const auto& prefix : spec.includePrefixes) {
+        IdRange range = index.PrefixRange(prefix);
+        if (range.begin < range.end) view.push_back(range);
+    }
+    std::sort(view.begin(), view.end(), [](const IdRange& a, const IdRange& b) { return a.begin < b.begin; });
+    std::vector<IdRange> merged;
+    for (const auto& range : view) {
+        if (!merged.empty() && range.begin <= merged.back().end) {
+            merged.back().end = std::max<uint32_t>(merged.back().end, range.end);
+        } else {
+            merged.push_back(range);
+        }
+    }
 
-    std::string lowerInput = input;
-    std::transform(lowerInput.begin(), lowerInput.end(), lowerInput.begin(), ::tolower);
+    for (const auto& prefix : spec.excludePrefixes) {
+        IdRange cut = index.PrefixRange(prefix);
+        if (cut.begin >= cut.end) continue;
+        std::vector<IdRange> remaining;
+        for (const auto& range : merged) {
+            if (cut.end <= range.begin || cut.begin >= range.end) {
+                remaining.push_back(range);
+                continue;
+            }
+            if (range.begin < cut.begin) remaining.push_back({ range.begin, cut.begin });
+            if (cut.end < range.end) remaining.push_back({ cut.end, range.end });
+        }
+        merged.swap(remaining);
+    }
+    return merged;
+}
 
-    auto addMatch = [&](const std::string& path) {
-        currentMatches.push_back(path);
-        const char* displayName = PathFindFileNameA(path.c_str());
-        SendMessage(hListBox, LB_ADDSTRING, 0, (LPARAM)displayName);
+static bool RunMatchRequest(const MatchRequest& request, MatchResult& result) {
+    static std::shared_ptr<const FolderIndex> workerIndex;
+    static const LauncherModeSpec* workerMode = nullptr;
+    static std::vector<IdRange> workerView;
+    static CandidateCache crawledCandidates;
+
+    auto matchStart = std::chrono::steady_clock::now();
+    std::shared_ptr<const FolderIndex> crawledSnapshot = CurrentCrawledIndex();
+    if (crawledSnapshot != workerIndex || request.mode != workerMode) {
+        workerIndex = crawledSnapshot;
+        workerMode = request.mode;
+        workerView = BuildModeView(*crawledSnapshot, *request.mode);
+        crawledCandidates.Clear();
+    }
+
+    const HistorySnapshot& history = *request.history;
+    const FolderIndex& crawled = *crawledSnapshot;
+    std::string lowerInput = LowerPattern(request.input);
+
+    bool exact = lowerInput[0] == '\'';
+    std::string_view pattern = exact ? std::string_view(lowerInput).substr(1) : std::string_view(lowerInput);
+    auto matches = [&](std::string_view path, std::string_view lowerPath, size_t basenameOffset, int& score) {
+        return exact ? ExactMatch(pattern, path, lowerPath, basenameOffset, score)
+                     : FuzzyMatch(pattern, path, lowerPath, basenameOffset, score);
     };
 
-    if (input.empty()) {
-        for (size_t i = 0; i < activeCtx->history.size() && i < maxPathsN; ++i) {
-            addMatch(activeCtx->history[i]);
+    TopMatches historyTop(maxPathsN);
+    for (size_t i = 0; i < history.paths.size(); ++i) {
+        int score;
+        if (matches(history.paths[i], history.lowerPaths[i], history.basenames[i], score)) {
+            historyTop.Offer(score + history.rankBonus[i], (uint32_t)i, (uint32_t)history.paths[i].size());
         }
-    } else {
-        for (const auto& path : activeCtx->history) {
-            if (currentMatches.size() >= maxPathsN) break;
+    }
 
-            std::string lowerPath = path;
-            std::transform(lowerPath.begin(), lowerPath.end(), lowerPath.begin(), ::tolower);
-            if (lowerPath.find(lowerInput) != std::string::npos) {
-                addMatch(path);
-            }
+    const std::vector<uint32_t>* candidates = pattern.empty() ? nullptr : crawledCandidates.Narrow(lowerInput);
+    std::vector<uint32_t> trigramCandidates;
+    if (exact && crawled.TrigramCandidates(pattern, trigramCandidates)) {
+        if (!candidates || trigramCandidates.size() < candidates->size()) candidates = &trigramCandidates;
+    }
+
+    IndexMatchOptions options;
+    options.lowerPattern = pattern;
+    options.exact = exact;
+    options.limit = maxPathsN;
+    options.isExcluded = [&history](std::string_view path) { return history.Contains(path); };
+    options.isCancelled = [&request] {
+        return matchGeneration.load(std::memory_order_relaxed) != request.generation;
+    };
+    IndexMatchResult crawledMatches;
+    MatchIndex(crawled, workerView, candidates, options, crawledMatches);
+    if (crawledMatches.cancelled) return false;
+
+    {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - matchStart;
+        std::lock_guard<std::mutex> lock(perfMutex);
+        matchPerf.Record(elapsed.count(), crawledMatches.visited, crawled.Size());
+    }
+
+    if (!pattern.empty()) crawledCandidates.Store(lowerInput, std::move(crawledMatches.survivors));
+
+    std::vector<ScoredMatch> historyBest = historyTop.Sorted();
+    const std::vector<ScoredMatch>& crawledBest = crawledMatches.best;
+    size_t h = 0;
+    size_t c = 0;
+    while (result.matches.size() < maxPathsN && (h < historyBest.size() || c < crawledBest.size())) {
+        bool takeHistory = c >= crawledBest.size() ||
+                           (h < historyBest.size() && historyBest[h].score >= crawledBest[c].score);
+        if (takeHistory) {
+            result.matches.push_back({ true, historyBest[h++].id });
+        } else {
+            result.matches.push_back({ false, crawledBest[c++].id });
         }
-        std::lock_guard<std::mutex> lock(crawlMutex);
-        for (const auto& path : allCrawledFolders) {
-            if (currentMatches.size() >= maxPathsN) break;
-            
-            if (std::find(activeCtx->history.begin(), activeCtx->history.end(), path) != activeCtx->history.end()) continue;
-            std::string lowerPath = path;
-            std::transform(lowerPath.begin(), lowerPath.end(), lowerPath.begin(), ::tolower);
-            if (lowerPath.find(lowerInput) != std::string::npos) {
-                addMatch(path);
-            }
+    }
+
+    result.generation = request.generation;
+    result.input = request.input;
+    result.history = request.history;
+    result.crawledIndex = crawledSnapshot;
+    return true;
+}
+
+static void MatchWorkerLoop() {
+    while (true) {
+        MatchRequest request;
+        {
+            std::unique_lock<std::mutex> lock(matchMutex);
+            matchCondition.wait(lock, [] { return matchRequestPending || matchWorkerStopping; });
+            if (matchWorkerStopping) return;
+            request = std::move(pendingRequest);
+            matchRequestPending = false;
+        }
+
+        MatchResult result;
+        if (!RunMatchRequest(request, result)) continue;
+        {
+            std::lock_guard<std::mutex> lock(matchMutex);
+            if (request.generation != matchGeneration) continue;
+            completedResult = std::move(result);
         }
+        PostMessage(request.target, WM_LAUNCHER_MATCHES, 0, 0);
+    }
+}
+
+static void StartMatchWorker() {
+    if (matchWorkerStarted) return;
+    matchWorkerStarted = true;
+    std::thread(MatchWorkerLoop).detach();
+}
+
+static void StopMatchWorker() {
+    std::lock_guard<std::mutex> lock(matchMutex);
+    matchWorkerStopping = true;
+    matchCondition.notify_one();
+}
+
+static void CancelPendingMatches() {
+    std::lock_guard<std::mutex> lock(matchMutex);
+    ++matchGeneration;
+    matchRequestPending = false;
+}
+
+static void SubmitMatchQuery(const std::string& input) {
+    std::lock_guard<std::mutex> lock(matchMutex);
+    pendingRequest.generation = ++matchGeneration;
+    pendingRequest.input = input;
+    pendingRequest.target = hLauncherWindow;
+    pendingRequest.mode = &activeCtx->spec;
+    pendingRequest.history = activeCtx->historySnapshot;
+    matchRequestPending = true;
+    matchCondition.notify_one();
+}
+
+static int VisibleResultRows() {
+    RECT rc;
+    GetClientRect(hResultList, &rc);
+    return std::max<int>(rc.bottom / resultRowHeight, 1);
+}
+
+static void ScrollResults(int delta) {
+    int lastTop = std::max<int>((int)currentMatches.size() - VisibleResultRows(), 0);
+    int next = std::min<int>(std::max<int>(topIndex + delta, 0), lastTop);
+    if (next == topIndex) return;
+    topIndex = next;
+    InvalidateRect(hResultList, NULL, FALSE);
+}
+
+static void SelectResult(int index) {
+    if (index < 0 || index >= (int)currentMatches.size()) return;
+    selectedIndex = index;
+    int rows = VisibleResultRows();
+    if (selectedIndex < topIndex) topIndex = selectedIndex;
+    if (selectedIndex >= topIndex + rows) topIndex = selectedIndex - rows + 1;
+    SetWindowTextA(hPathLabel, MatchPath(currentMatches[selectedIndex]).c_str());
+    InvalidateRect(hResultList, NULL, FALSE);
+}
+
+// A refresh of the same query, as after an index update, keeps the
+// selected folder on the same row instead of jumping back to the top.
+static void ShowMatchResult(MatchResult& result) {
+    std::string keptPath;
+    int keptRow = 0;
+    if (result.input == shownInput && selectedIndex >= 0 && selectedIndex < (int)currentMatches.size()) {
+        keptPath = MatchPath(currentMatches[selectedIndex]);
+        keptRow = selectedIndex - topIndex;
     }
+    shownInput = result.input;
+
+    currentMatches.swap(result.matches);
+    matchedHistory = result.history;
+    matchedIndex = result.crawledIndex;
+    selectedIndex = -1;
+    topIndex = 0;
 
     if (!currentMatches.empty()) {
-        SendMessage(hListBox, LB_SETCURSEL, 0, 0);
-        SetWindowTextA(hPathLabel, currentMatches[0].c_str());
+        int selected = 0;
+        for (int i = 0; !keptPath.empty() && i < (int)currentMatches.size(); ++i) {
+            if (MatchPath(currentMatches[i]) == keptPath) {
+                selected = i;
+                int lastTop = std::max<int>((int)currentMatches.size() - VisibleResultRows(), 0);
+                topIndex = std::min<int>(std::max<int>(selected - keptRow, 0), lastTop);
+                break;
+            }
+        }
+        SelectResult(selected);
     } else {
-        if (isScanning) {
-            SetWindowTextA(hPathLabel, activeCtx->placeholder.c_str());
+        if (isScanning || !areRootsReady) {
+            SetWindowTextA(hPathLabel, activeCtx->spec.placeholder.c_str());
         } else {
-            SetWindowTextA(hPathLabel, input.empty() ? "" : "No matches found.");
+            SetWindowTextA(hPathLabel, result.input.empty() ? "" : "No matches found.");
         }
     }
 
-    InvalidateRect(hListBox, NULL, FALSE);
-    UpdateWindow(hListBox);
+    InvalidateRect(hResultList, NULL, FALSE);
+    UpdateWindow(hResultList);
+}
+
+// Until the startup pipeline has looked for the executables, the launcher
+// still matches against history and the saved index; only launching waits.
+static bool IsEngineMissing() {
+    return areEnginesReady && !activeCtx->isEngineFound;
+}
+
+static void RefreshMatches(std::string input) {
+    if (IsEngineMissing()) {
+        currentMatches.clear();
+        selectedIndex = -1;
+        topIndex = 0;
+        InvalidateRect(hResultList, NULL, FALSE);
+        SetWindowTextA(hPathLabel, "ERROR: executable not found! Check your installation.");
+        return;
+    }
+
+    if (!input.empty()) {
+        SubmitMatchQuery(input);
+        return;
+    }
+
+    CancelPendingMatches();
+    MatchResult result;
+    result.history = activeCtx->historySnapshot;
+    for (size_t i = 0; i < result.history->paths.size() && i < maxPathsN; ++i) {
+        result.matches.push_back({ true, (uint32_t)i });
+    }
+    ShowMatchResult(result);
+}
+
+// The popup is only hidden; its controls, fonts and region stay built for
+// the next hotkey press.
+static void HideLauncher() {
+    HWND hwnd = hLauncherWindow.exchange(NULL);
+    if (!hwnd) return;
+    CancelPendingMatches();
+    KillTimer(hResultList, 1);
+    currentMatches.clear();
+    shownInput.clear();
+    selectedIndex = -1;
+    topIndex = 0;
+    pendingIndex = -1;
+    isShowTimed = false;
+    matchedHistory.reset();
+    matchedIndex.reset();
+    ShowWindow(hwnd, SW_HIDE);
 }
 
 static LRESULT CALLBACK EditSubclassProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam, UINT_PTR, DWORD_PTR) {
     if (uMsg == WM_KEYDOWN) {
+        if (wParam == VK_RETURN && !areEnginesReady) return 0;
         if (wParam == VK_RETURN && !currentMatches.empty()) {
-            int sel = SendMessage(hListBox, LB_GETCURSEL, 0, 0);
-            if (sel != LB_ERR && sel < (int)currentMatches.size()) {
-                ExecuteLaunch(sel);
+            if (selectedIndex >= 0 && selectedIndex < (int)currentMatches.size()) {
+                ExecuteLaunch(selectedIndex);
             }
-            DestroyWindow(hLauncherWindow);
+            HideLauncher();
             return 0;
         }
         if (wParam == VK_ESCAPE) {
-            DestroyWindow(hLauncherWindow);
+            HideLauncher();
             return 0;
         }
         if (wParam == VK_DOWN || wParam == VK_UP) {
-            int count = SendMessage(hListBox, LB_GETCOUNT, 0, 0);
-            int cur = SendMessage(hListBox, LB_GETCURSEL, 0, 0);
-            int next = (wParam == VK_DOWN) ? (cur + 1) % count : (cur - 1 + count) % count;
-            SendMessage(hListBox, LB_SETCURSEL, next, 0);
-            SetWindowTextA(hPathLabel, currentMatches[next].c_str());
-            InvalidateRect(hListBox, NULL, FALSE);
+            int count = (int)currentMatches.size();
+            if (count == 0) return 0;
+            int next = (wParam == VK_DOWN) ? (selectedIndex + 1) % count : (selectedIndex - 1 + count) % count;
+            SelectResult(next);
+            return 0;
+        }
+        if (wParam == VK_NEXT || wParam == VK_PRIOR) {
+            int count = (int)currentMatches.size();
+            if (count == 0) return 0;
+            int page = (wParam == VK_NEXT) ? VisibleResultRows() : -VisibleResultRows();
+            SelectResult(std::min<int>(std::max<int>(selectedIndex + page, 0), count - 1));
             return 0;
         }
     }
+    if (uMsg == WM_MOUSEWHEEL) {
+        return SendMessage(hResultList, WM_MOUSEWHEEL, wParam, lParam);
+    }
     return DefSubclassProc(hwnd, uMsg, wParam, lParam);
 }
 
-static LRESULT CALLBACK ListBoxSubclassProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam, UINT_PTR, DWORD_PTR) {
+static void ReleaseFadedLogo(LauncherContext& ctx) {
+    if (ctx.fadedLogo) {
+        DeleteObject(ctx.fadedLogo);
+        ctx.fadedLogo = NULL;
+    }
+    ctx.fadedLogoWidth = 0;
+    ctx.fadedLogoHeight = 0;
+}
+
+// The scaled, faded logo only changes with the window size, so it is
+// composited once into a premultiplied DIB and then only alpha-blitted.
+static HBITMAP GetFadedLogo(LauncherContext& ctx, int width, int height) {
+    if (ctx.fadedLogo && ctx.fadedLogoWidth == width && ctx.fadedLogoHeight == height) return ctx.fadedLogo;
+    ReleaseFadedLogo(ctx);
+    if (width <= 0 || height <= 0) return NULL;
+
+    PixelBuffer faded;
+    ScaleAndFade(ctx.logo, width, height, logoOpacity, faded);
+
+    BITMAPINFO bmi {};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = width;
+    bmi.bmiHeader.biHeight = -height;
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+    void* bits = nullptr;
+    HBITMAP hBitmap = CreateDIBSection(NULL, &bmi, DIB_RGB_COLORS, &bits, NULL, 0);
+    if (!hBitmap) return NULL;
+    memcpy(bits, faded.pixels.data(), faded.pixels.size() * sizeof(uint32_t));
+
+    ctx.fadedLogo = hBitmap;
+    ctx.fadedLogoWidth = width;
+    ctx.fadedLogoHeight = height;
+    return hBitmap;
+}
+
+static bool EnsureBackBuffer(HDC hdc, int width, int height) {
+    if (hBackBuffer && backBufferWidth == width && backBufferHeight == height) return true;
+    if (width <= 0 || height <= 0) return false;
+
+    HBITMAP hBitmap = CreateCompatibleBitmap(hdc, width, height);
+    if (!hBitmap) return false;
+    if (!hBackBufferDC) hBackBufferDC = CreateCompatibleDC(hdc);
+    HGDIOBJ previous = SelectObject(hBackBufferDC, hBitmap);
+    if (hBackBuffer) {
+        DeleteObject(previous);
+    } else {
+        hBackBufferDefault = previous;
+    }
+    hBackBuffer = hBitmap;
+    backBufferWidth = width;
+    backBufferHeight = height;
+    return true;
+}
+
+static void ReleaseBackBuffer() {
+    if (hBackBufferDC) {
+        if (hBackBuffer) SelectObject(hBackBufferDC, hBackBufferDefault);
+        DeleteDC(hBackBufferDC);
+        hBackBufferDC = NULL;
+    }
+    if (hBackBuffer) {
+        DeleteObject(hBackBuffer);
+        hBackBuffer = NULL;
+    }
+    hBackBufferDefault = NULL;
+    backBufferWidth = 0;
+    backBufferHeight = 0;
+}
+
+// A 1x1 premultiplied pixel that AlphaBlend stretches over the selected row,
+// so the highlight stays translucent over the logo.
+static HBITMAP CreateTintBitmap(BYTE red, BYTE green, BYTE blue, BYTE alpha) {
+    BITMAPINFO bmi {};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = 1;
+    bmi.bmiHeader.biHeight = 1;
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+    void* bits = nullptr;
+    HBITMAP hBitmap = CreateDIBSection(NULL, &bmi, DIB_RGB_COLORS, &bits, NULL, 0);
+    if (!hBitmap) return NULL;
+    *(uint32_t*)bits = ((uint32_t)alpha << 24) | ((uint32_t)(red * alpha / 255) << 16) |
+                       ((uint32_t)(green * alpha / 255) << 8) | (uint32_t)(blue * alpha / 255);
+    return hBitmap;
+}
+
+static void PaintResultList(HWND hwnd, HDC hdc) {
+    RECT rcList;
+    GetClientRect(hwnd, &rcList);
+    if (!EnsureBackBuffer(hdc, rcList.right, rcList.bottom)) return;
+    HDC memDC = hBackBufferDC;
+    if (!hSpriteDC) hSpriteDC = CreateCompatibleDC(hdc);
+    BLENDFUNCTION blend = { AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
+
+    FillRect(memDC, &rcList, hLauncherBgBrush);
+
+    if (areLogosReady && !activeCtx->logo.Empty()) {
+        HWND hParent = GetParent(hwnd);
+        RECT rcMain;
+        GetClientRect(hParent, &rcMain);
+
+        POINT ptListOffset = {0, 0};
+        MapWindowPoints(hwnd, hParent, &ptListOffset, 1);
+
+        float aspectRatio = (float)activeCtx->logo.width / activeCtx->logo.height;
+        int imgHeight = (int)(rcMain.bottom * 0.55);
+        int imgWidth = (int)(imgHeight * aspectRatio);
+
+        int finalX = rcMain.right / 2 - (imgWidth / 2) - ptListOffset.x;
+        int finalY = rcMain.bottom / 2 - (imgHeight / 2) - ptListOffset.y;
+
+        HBITMAP hLogo = GetFadedLogo(*activeCtx, imgWidth, imgHeight);
+        if (hLogo) {
+            HGDIOBJ oldSprite = SelectObject(hSpriteDC, hLogo);
+            AlphaBlend(memDC, finalX, finalY, imgWidth, imgHeight, hSpriteDC, 0, 0, imgWidth, imgHeight, blend);
+            SelectObject(hSpriteDC, oldSprite);
+        }
+    }
+
+    // Only the rows on screen are touched; each one reads its path straight
+    // from the match result, however many results are kept.
+    int count = (int)currentMatches.size();
+    int rows = VisibleResultRows();
+    SetBkMode(memDC, TRANSPARENT);
+    HGDIOBJ oldFont = SelectObject(memDC, hGlobalFont);
+    for (int i = topIndex; i < count && i < topIndex + rows; ++i) {
+        RECT rcRow = { 0, (i - topIndex) * resultRowHeight, rcList.right, (i - topIndex + 1) * resultRowHeight };
+        bool sel = i == selectedIndex;
+        if (sel && hSelectionBitmap) {
+            HGDIOBJ oldSprite = SelectObject(hSpriteDC, hSelectionBitmap);
+            AlphaBlend(memDC, rcRow.left, rcRow.top, rcRow.right - rcRow.left, rcRow.bottom - rcRow.top,
+                       hSpriteDC, 0, 0, 1, 1, blend);
+            SelectObject(hSpriteDC, oldSprite);
+        }
+
+        std::string path = MatchPath(currentMatches[i]);
+        size_t separator = path.find_last_of("\\/");
+        const char* displayName = path.c_str() + (separator == std::string::npos ? 0 : separator + 1);
+        SetTextColor(memDC, sel ? RGB(255, 255, 255) : RGB(200, 200, 200));
+
+        RECT textRect = rcRow;
+        textRect.left += 15;
+        DrawTextA(memDC, displayName, -1, &textRect, DT_SINGLELINE | DT_VCENTER | DT_NOPREFIX | DT_END_ELLIPSIS);
+    }
+    SelectObject(memDC, oldFont);
+
+    if (count > rows) {
+        int thumbH = std::max<int>(rcList.bottom * rows / count, resultRowHeight / 2);
+        int thumbY = (rcList.bottom - thumbH) * topIndex / (count - rows);
+        RECT rcThumb = { rcList.right - 4, thumbY, rcList.right, thumbY + thumbH };
+        FillRect(memDC, &rcThumb, hScrollThumbBrush);
+    }
+
+    BitBlt(hdc, 0, 0, rcList.right, rcList.bottom, memDC, 0, 0, SRCCOPY);
+}
+
+static int ResultRowFromPoint(LPARAM lParam) {
+    int y = (short)HIWORD(lParam);
+    if (y < 0) return -1;
+    int row = y / resultRowHeight;
+    if (row >= VisibleResultRows()) return -1;
+    int index = topIndex + row;
+    return index < (int)currentMatches.size() ? index : -1;
+}
+
+static LRESULT CALLBACK ResultListProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
     switch (uMsg) {
         case WM_ERASEBKGND: {
             return 1;
@@ -520,76 +1690,25 @@ static LRESULT CALLBACK ListBoxSubclassProc(HWND hwnd, UINT uMsg, WPARAM wParam,
         case WM_PAINT: {
             PAINTSTRUCT ps;
             HDC hdc = BeginPaint(hwnd, &ps);
-            
-            RECT rcList;
-            GetClientRect(hwnd, &rcList);
-
-            HWND hParent = GetParent(hwnd);
-            RECT rcMain;
-            GetClientRect(hParent, &rcMain);
-            
-            float aspectRatio = (float)activeCtx->logoImage->GetWidth() / activeCtx->logoImage->GetHeight();
-            int imgHeight = (int)(rcMain.bottom * 0.55);
-            int imgWidth = (int)(imgHeight * aspectRatio);
-
-            POINT ptListOffset = {0, 0};
-            MapWindowPoints(hwnd, hParent, &ptListOffset, 1);
-
-            HDC memDC = CreateCompatibleDC(hdc);
-            HBITMAP memBmp = CreateCompatibleBitmap(hdc, rcList.right, rcList.bottom);
-            HGDIOBJ oldBmp = SelectObject(memDC, memBmp);
-
-            FillRect(memDC, &rcList, hLauncherBgBrush);
-
-            if (activeCtx->logoImage) {
-                Gdiplus::Graphics graphics(memDC);
-                graphics.SetInterpolationMode(Gdiplus::InterpolationModeLowQuality);
-                graphics.SetPageUnit(Gdiplus::UnitPixel);
-
-                int mainCenterX = rcMain.right / 2;
-                int mainCenterY = rcMain.bottom / 2;
-
-                int logoXInMain = mainCenterX - (imgWidth / 2);
-                int logoYInMain = mainCenterY - (imgHeight / 2);
-
-                int finalX = logoXInMain - ptListOffset.x;
-                int finalY = logoYInMain - ptListOffset.y;
-
-                static Gdiplus::ImageAttributes attr;
-                static bool attrInit = false;
-                if (!attrInit) {
-                    Gdiplus::ColorMatrix matrix = {1,0,0,0,0, 0,1,0,0,0, 0,0,1,0,0, 0,0,0,0.12f,0, 0,0,0,0,1};
-                    attr.SetColorMatrix(&matrix);
-                    attrInit = true;
-                }
-
-                graphics.DrawImage(
-                    activeCtx->logoImage,
-                    Gdiplus::Rect(finalX, finalY, imgWidth, imgHeight),
-                    0, 0,
-                    activeCtx->logoImage->GetWidth(),
-                    activeCtx->logoImage->GetHeight(),
-                    Gdiplus::UnitPixel,
-                    &attr
-                );
+            PaintResultList(hwnd, hdc);
+            EndPaint(hwnd, &ps);
+            if (isShowTimed) {
+                isShowTimed = false;
+                std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - showStart;
+                std::lock_guard<std::mutex> lock(perfMutex);
+                showPerf.Record(elapsed.count(), isShowRebuilt);
             }
-
-            SendMessage(hwnd, WM_PRINTCLIENT, (WPARAM)memDC, PRF_CLIENT);
-
-            BitBlt(hdc, 0, 0, rcList.right, rcList.bottom, memDC, 0, 0, SRCCOPY);
-
-            SelectObject(memDC, oldBmp);
-            DeleteObject(memBmp);
-            DeleteDC(memDC);
-            EndPaint(hwnd, &ps);            
+            return 0;
+        }
+        case WM_MOUSEWHEEL: {
+            int notches = GET_WHEEL_DELTA_WPARAM(wParam) / WHEEL_DELTA;
+            ScrollResults(-notches * 3);
             return 0;
         }
         case WM_MOUSEMOVE: {
-            LRESULT result = SendMessage(hwnd, LB_ITEMFROMPOINT, 0, lParam);
-            if (HIWORD(result) == 0) {
-                int hoveredIndex = LOWORD(result);
-                int currentSel = (int)SendMessage(hwnd, LB_GETCURSEL, 0, 0);
-                if (hoveredIndex != currentSel && hoveredIndex != pendingIndex && hoveredIndex < (int)currentMatches.size()) {
+            int hoveredIndex = ResultRowFromPoint(lParam);
+            if (hoveredIndex != -1) {
+                if (hoveredIndex != selectedIndex && hoveredIndex != pendingIndex) {
                     pendingIndex = hoveredIndex;
                     KillTimer(hwnd, 1);
                     SetTimer(hwnd, 1, 25, NULL);
@@ -598,29 +1717,28 @@ static LRESULT CALLBACK ListBoxSubclassProc(HWND hwnd, UINT uMsg, WPARAM wParam,
                 KillTimer(hwnd, 1);
                 pendingIndex = -1;
             }
-            break;
+            return 0;
         }
         case WM_TIMER: {
             if (wParam == 1) {
                 KillTimer(hwnd, 1);
-                if (pendingIndex != -1) {
-                    SendMessage(hwnd, LB_SETCURSEL, pendingIndex, 0);
-                    SetWindowTextA(hPathLabel, currentMatches[pendingIndex].c_str());
-                    InvalidateRect(hwnd, NULL, FALSE);
-                }
+                if (pendingIndex != -1) SelectResult(pendingIndex);
+                pendingIndex = -1;
             }
             return 0;
         }
         case WM_LBUTTONDOWN: {
-            int sel = (int)SendMessage(hwnd, LB_GETCURSEL, 0, 0);
-            if (sel != LB_ERR && sel < (int)currentMatches.size()) {
-                ExecuteLaunch(sel);
+            if (!areEnginesReady) return 0;
+            int clicked = ResultRowFromPoint(lParam);
+            if (clicked == -1) clicked = selectedIndex;
+            if (clicked >= 0 && clicked < (int)currentMatches.size()) {
+                ExecuteLaunch(clicked);
             }
-            DestroyWindow(hLauncherWindow);
+            HideLauncher();
             return 0;
         }
     }
-    return DefSubclassProc(hwnd, uMsg, wParam, lParam);
+    return DefWindowProc(hwnd, uMsg, wParam, lParam);
 }
 
 static LRESULT CALLBACK LauncherWindProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
@@ -631,10 +1749,6 @@ static LRESULT CALLBACK LauncherWindProc(HWND hwnd, UINT msg, WPARAM wParam, LPA
             SetBkColor(hdc, RGB(30, 30, 30));
             return (INT_PTR)hEditBgBrush;
         }
-        case WM_CTLCOLORLISTBOX: {
-            SetBkMode((HDC)wParam, TRANSPARENT);
-            return (LRESULT)GetStockObject(NULL_BRUSH);
-        }
         case WM_CTLCOLORSTATIC: {
             HDC hdc = (HDC)wParam;
             SetTextColor(hdc, RGB(150, 150, 150));
@@ -652,37 +1766,27 @@ static LRESULT CALLBACK LauncherWindProc(HWND hwnd, UINT msg, WPARAM wParam, LPA
             EndPaint(hwnd, &ps);
             return 0;
         }
-        case WM_DRAWITEM: {
-            PDRAWITEMSTRUCT pdis = (PDRAWITEMSTRUCT)lParam;
-            if (pdis->itemID == (UINT)-1) return TRUE;
-            bool sel = pdis->itemState & ODS_SELECTED;
-            if (sel) {
-                Gdiplus::Graphics g(pdis->hDC);
-                Gdiplus::SolidBrush b(Gdiplus::Color(128, 100, 100, 100));
-                g.FillRectangle(
-                    &b,
-                    (int)pdis->rcItem.left,
-                    (int)pdis->rcItem.top,
-                    pdis->rcItem.right - pdis->rcItem.left,
-                    pdis->rcItem.bottom - pdis->rcItem.top
-                );
+        case WM_LAUNCHER_MATCHES: {
+            if (hwnd != hLauncherWindow) return 0;
+            MatchResult result;
+            {
+                std::lock_guard<std::mutex> lock(matchMutex);
+                if (completedResult.generation != matchGeneration) return 0;
+                result = std::move(completedResult);
+                completedResult = MatchResult();
             }
+            ShowMatchResult(result);
+            return 0;
+        }
+        case WM_LAUNCHER_INDEX_UPDATED: {
+            if (hwnd != hLauncherWindow) return 0;
             char buffer[256];
-            SendMessage(pdis->hwndItem, LB_GETTEXT, pdis->itemID, (LPARAM)buffer);
-            SetTextColor(pdis->hDC, sel ? RGB(255, 255, 255) : RGB(200, 200, 200));
-
-            SetBkMode(pdis->hDC, TRANSPARENT);
-            
-            RECT textRect = pdis->rcItem;
-            textRect.left += 15;
-            HGDIOBJ oldFont = SelectObject(pdis->hDC, hGlobalFont);
-            DrawTextA(pdis->hDC, buffer, -1, &textRect, DT_SINGLELINE | DT_VCENTER | DT_NOPREFIX);
-            SelectObject(pdis->hDC, oldFont);
-            
-            return TRUE;
+            GetWindowTextA(hEdit, buffer, 256);
+            RefreshMatches(buffer);
+            return 0;
         }
         case WM_COMMAND: {
-            if (HIWORD(wParam) == EN_CHANGE) {
+            if (hwnd == hLauncherWindow && HIWORD(wParam) == EN_CHANGE) {
                 char buffer[256];
                 GetWindowTextA(hEdit, buffer, 256);
                 RefreshMatches(buffer);
@@ -690,25 +1794,54 @@ static LRESULT CALLBACK LauncherWindProc(HWND hwnd, UINT msg, WPARAM wParam, LPA
             return 0;
         }
         case WM_ACTIVATE: {
-            if (LOWORD(wParam) == WA_INACTIVE) {
-                DestroyWindow(hwnd);
+            if (LOWORD(wParam) == WA_INACTIVE && hwnd == hLauncherWindow) {
+                HideLauncher();
              }
              return 0;
         }
         case WM_KEYDOWN: {
-            if (wParam == VK_ESCAPE) {
-                DestroyWindow(hwnd);
+            if (wParam == VK_ESCAPE && hwnd == hLauncherWindow) {
+                HideLauncher();
             }
             return 0;
         }
-        case WM_DESTROY: {
-            hLauncherWindow = NULL;
-            return 0;
+        case WM_DPICHANGED:
+        case WM_DISPLAYCHANGE: {
+            for (auto& ctx : launcherContexts) {
+                if (ctx.window.hWindow == hwnd) ctx.window.isStale = true;
+            }
+            break;
         }
     }
     return DefWindowProc(hwnd, msg, wParam, lParam);
 }
 
+// Decodes the logo once into straight-alpha pixels; painting never touches
+// GDI+ after this.
+static PixelBuffer ReadImagePixels(Gdiplus::Image* image) {
+    PixelBuffer buffer;
+    if (!image) return buffer;
+    UINT width = image->GetWidth();
+    UINT height = image->GetHeight();
+    Gdiplus::Bitmap bitmap(width, height, PixelFormat32bppARGB);
+    {
+        Gdiplus::Graphics graphics(&bitmap);
+        graphics.DrawImage(image, 0, 0, width, height);
+    }
+
+    Gdiplus::BitmapData data;
+    Gdiplus::Rect rect(0, 0, width, height);
+    if (bitmap.LockBits(&rect, Gdiplus::ImageLockModeRead, PixelFormat32bppARGB, &data) != Gdiplus::Ok) return buffer;
+    buffer.width = (int)width;
+    buffer.height = (int)height;
+    buffer.pixels.resize((size_t)width * height);
+    for (UINT y = 0; y < height; ++y) {
+        memcpy(&buffer.pixels[(size_t)y * width], (const BYTE*)data.Scan0 + (size_t)y * data.Stride, width * sizeof(uint32_t));
+    }
+    bitmap.UnlockBits(&data);
+    return buffer;
+}
+
 static Gdiplus::Image* LoadImageFromResource(int resourceID) {
     HRSRC hRes = FindResourceA(NULL, MAKEINTRESOURCEA(resourceID), (LPCSTR)RT_RCDATA);
     if (!hRes) return nullptr;
@@ -735,34 +1868,92 @@ static Gdiplus::Image* LoadImageFromResource(int resourceID) {
     return img;
 }
 
-void InitializeLauncher() {
-    SetUpStoragePath();
+// A logo is an RCDATA resource number or, for launchers added in the
+// config, an image file.
+static Gdiplus::Image* LoadLogo(const std::string& logo) {
+    if (logo.empty()) return nullptr;
+    if (logo.find_first_not_of("0123456789") == std::string::npos) return LoadImageFromResource(std::atoi(logo.c_str()));
+
+    std::string path = ExpandEnvironment(logo);
+    int size = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, NULL, 0);
+    if (size <= 0) return nullptr;
+    std::wstring widePath(size, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &widePath[0], size);
+    Gdiplus::Image* img = Gdiplus::Image::FromFile(widePath.c_str());
+    if (img && img->GetLastStatus() != Gdiplus::Ok) {
+        delete img;
+        return nullptr;
+    }
+    return img;
+}
 
-    ctxVSCode.type = LauncherMode::VSCode;
-    ctxVSCode.historyFileName = "vscodelauncher_history.txt";
-    ctxVSCode.logoResourceID = 101;
-    FindVSCode(ctxVSCode);
-    ctxVSCode.logoImage = LoadImageFromResource(ctxVSCode.logoResourceID);
-    ctxVSCode.placeholder = "Search for VS Code projects...";
-    LoadHistory(ctxVSCode);
+static double ElapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
 
-    ctxWSL.type = LauncherMode::WSL;
-    ctxWSL.historyFileName = "wsllauncher_history.txt";
-    ctxWSL.logoResourceID = 102;
-    FindWSL(ctxWSL);
-    ctxWSL.logoImage = LoadImageFromResource(ctxWSL.logoResourceID);
-    ctxWSL.placeholder = "Search for WSL directories...";
-    LoadHistory(ctxWSL);
+template <typename Stage>
+static void RunStartupStage(const char* name, std::chrono::steady_clock::time_point origin,
+                            std::vector<StageTiming>& timings, Stage stage) {
+    if (isStartupCancelled) return;
+    auto start = std::chrono::steady_clock::now();
+    stage();
+    timings.push_back({ name, ElapsedMs(origin, start), ElapsedMs(start, std::chrono::steady_clock::now()) });
+}
 
-    hLauncherBgBrush = CreateSolidBrush(RGB(30, 30, 30));
-    hEditBgBrush = CreateSolidBrush(RGB(30, 30, 30));
-    hListBoxBgBrush = CreateSolidBrush(RGB(45, 45, 45));
+static void NotifyLauncherWindow() {
+    HWND target = hLauncherWindow;
+    if (target) PostMessage(target, WM_LAUNCHER_INDEX_UPDATED, 0, 0);
+}
 
-    InitializeCrawlerRootPaths();
-    BackgroundCrawl();
+// Everything that can block on GDI+ decoding, wsl.exe or a WSL UNC share
+// runs here, while the UI thread pumps messages. The thread publishes its
+// own handle so StopStartupPipeline can cancel a blocked listing.
+static void RunStartupPipeline(std::chrono::steady_clock::time_point origin, std::vector<StageTiming> timings) {
+    HANDLE thread = NULL;
+    DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &thread, 0, FALSE,
+                    DUPLICATE_SAME_ACCESS);
+    hStartupThread = thread;
+
+    RunStartupStage("engines", origin, timings, [] {
+        for (auto& ctx : launcherContexts) FindEngine(ctx);
+        areEnginesReady = true;
+        NotifyLauncherWindow();
+    });
+    RunStartupStage("logos", origin, timings, [] {
+        for (auto& ctx : launcherContexts) {
+            Gdiplus::Image* image = LoadLogo(ctx.spec.logo);
+            ctx.logo = ReadImagePixels(image);
+            delete image;
+        }
+        areLogosReady = true;
+        HWND target = hResultList;
+        if (target) InvalidateRect(target, NULL, FALSE);
+    });
+    RunStartupStage("roots", origin, timings, [] {
+        InitializeCrawlerRootPaths();
+        if (isStartupCancelled) return;
+        StartFolderWatcher();
+        areRootsReady = true;
+    });
+    RunStartupStage("crawlStart", origin, timings, [] {
+        BackgroundCrawl();
+    });
+
+    if (!indexBaseDir.empty() && !isStartupCancelled) SaveStartupReport(indexBaseDir + "\\startup_report.json", timings);
+    isStartupFinished = true;
 }
 
-static void ApplyScaledFonts(int winHeight) {
+// Every mode's window has the same size, so they share one pair of fonts
+// and only a new size recreates them.
+static void ApplyScaledFonts(HWND hEditControl, HWND hLabelControl, int winHeight) {
+    static int scaledHeight = 0;
+    if (hGlobalFont && scaledHeight == winHeight) {
+        SendMessage(hEditControl,  WM_SETFONT, (WPARAM)hGlobalFont, TRUE);
+        SendMessage(hLabelControl, WM_SETFONT, (WPARAM)hSmallFont,  TRUE);
+        return;
+    }
+    scaledHeight = winHeight;
+
     if (hGlobalFont) {
         DeleteObject(hGlobalFont);
         hGlobalFont = NULL;
@@ -800,48 +1991,59 @@ static void ApplyScaledFonts(int winHeight) {
         "Consolas"
     );
 
-    SendMessage(hEdit,      WM_SETFONT, (WPARAM)hGlobalFont, TRUE);
-    SendMessage(hListBox,   WM_SETFONT, (WPARAM)hGlobalFont, TRUE);    
-    SendMessage(hPathLabel, WM_SETFONT, (WPARAM)hSmallFont,  TRUE);
+    SendMessage(hEditControl,  WM_SETFONT, (WPARAM)hGlobalFont, TRUE);
+    SendMessage(hLabelControl, WM_SETFONT, (WPARAM)hSmallFont,  TRUE);
 }
 
-void ShowLauncher(LauncherMode mode) {
-    if (hLauncherWindow) return;
+static void RegisterLauncherClasses() {
+    if (launcherClassRegistered) return;
+
+    WNDCLASSA wc {};
+    wc.lpfnWndProc = LauncherWindProc;
+    wc.hInstance = GetModuleHandle(NULL);
+    wc.lpszClassName = "KinesisLauncher";
+    wc.hCursor = LoadCursor(NULL, IDC_ARROW);
+    RegisterClassA(&wc);
+
+    WNDCLASSA listClass {};
+    listClass.lpfnWndProc = ResultListProc;
+    listClass.hInstance = GetModuleHandle(NULL);
+    listClass.lpszClassName = "KinesisResultList";
+    listClass.hCursor = LoadCursor(NULL, IDC_ARROW);
+    RegisterClassA(&listClass);
+    launcherClassRegistered = true;
+}
 
-    switch (mode) {
-        case LauncherMode::VSCode:
-            activeCtx = &ctxVSCode;
-            break;
-        case LauncherMode::WSL:
-            activeCtx = &ctxWSL;
-            break;
-        default:
-            return;
-    }
+static void DestroyLauncherWindow(LauncherContext& ctx) {
+    LauncherWindow& window = ctx.window;
+    if (!window.hWindow) return;
+    RemoveWindowSubclass(window.hEdit, EditSubclassProc, 0);
+    DestroyWindow(window.hWindow);
+    window = LauncherWindow();
+}
 
-    if (!launcherClassRegistered) {
-        WNDCLASSA wc {};
-        wc.lpfnWndProc = LauncherWindProc;
-        wc.hInstance = GetModuleHandle(NULL);
-        wc.lpszClassName = "KinesisLauncher";
-        wc.hCursor = LoadCursor(NULL, IDC_ARROW);
-        RegisterClassA(&wc);
-        launcherClassRegistered = true;
-    }
+// Builds the hidden popup of one mode. Showing it later only resets the
+// query and selection.
+static void BuildLauncherWindow(LauncherContext& ctx) {
+    DestroyLauncherWindow(ctx);
+    RegisterLauncherClasses();
+    LauncherWindow& window = ctx.window;
 
     int screenW = GetSystemMetrics(SM_CXSCREEN);
     int screenH = GetSystemMetrics(SM_CYSCREEN);
+    window.screenWidth = screenW;
+    window.screenHeight = screenH;
 
     int winW = screenW * 0.50;
     int winH = screenH * 0.40;
     int winX = (screenW - winW) / 2;
     int winY = (screenH - winH) / 3;
 
-    hLauncherWindow = CreateWindowExA(
+    window.hWindow = CreateWindowExA(
         WS_EX_TOPMOST | WS_EX_TOOLWINDOW,
         "KinesisLauncher",
         NULL,
-        WS_POPUP | WS_VISIBLE,
+        WS_POPUP,
         winX, winY, winW , winH,
         NULL, NULL,
         GetModuleHandle(NULL),
@@ -853,13 +2055,13 @@ void ShowLauncher(LauncherMode mode) {
     int innerWidth = winW - (margin * 2);
 
     int editH = winH * 0.12;
-    hEdit = CreateWindowExA(
+    window.hEdit = CreateWindowExA(
         0,
         "EDIT",
         "",
          WS_CHILD | WS_VISIBLE | ES_AUTOHSCROLL,
          margin, currentY, innerWidth, editH,
-         hLauncherWindow,
+         window.hWindow,
          NULL,
          GetModuleHandle(NULL),
          NULL
@@ -868,51 +2070,111 @@ void ShowLauncher(LauncherMode mode) {
 
     int pathH = winH * 0.10;
     int listH = winH - currentY - pathH - (margin * 2);
-    hListBox = CreateWindowExA(
+    window.rowHeight = std::max<int>((int)(winH * 0.12), 1);
+    window.hResultList = CreateWindowExA(
         0,
-        "LISTBOX",
+        "KinesisResultList",
         NULL,
-        WS_CHILD | WS_VISIBLE | WS_VSCROLL | LBS_NOTIFY | LBS_HASSTRINGS | LBS_OWNERDRAWFIXED,
+        WS_CHILD | WS_VISIBLE,
         margin, currentY, innerWidth, listH,
-        hLauncherWindow,
+        window.hWindow,
         NULL,
         GetModuleHandle(NULL),
         NULL
     );
     currentY += listH + (margin / 2);
 
-    hPathLabel = CreateWindowExA(
+    window.hPathLabel = CreateWindowExA(
         0,
         "STATIC",
         "",
         WS_CHILD | WS_VISIBLE | SS_LEFTNOWORDWRAP,
         margin, currentY, innerWidth,
         pathH,
-        hLauncherWindow,
+        window.hWindow,
         NULL,
         GetModuleHandle(NULL),
         NULL
     );
 
-    if (!activeCtx->isEngineFound) {
-        EnableWindow(hEdit, FALSE);
-        SetWindowTextA(hEdit, "");
-    }
-
-    ApplyScaledFonts(winH);
-
-    SendMessage(hListBox, LB_SETITEMHEIGHT, 0, (LPARAM)(winH * 0.12));
+    ApplyScaledFonts(window.hEdit, window.hPathLabel, winH);
 
     int cornerRadius = winH * 0.06;
     HRGN hMainRgn = CreateRoundRectRgn(0, 0, winW, winH, cornerRadius, cornerRadius);
-    SetWindowRgn(hLauncherWindow, hMainRgn, TRUE);
+    SetWindowRgn(window.hWindow, hMainRgn, FALSE);
 
-    SetWindowSubclass(hEdit, EditSubclassProc, 0, 0);
-    SetWindowSubclass(hListBox, ListBoxSubclassProc, 0, 0);
+    SetWindowSubclass(window.hEdit, EditSubclassProc, 0, 0);
+}
+
+static bool IsLauncherWindowCurrent(const LauncherWindow& window) {
+    return window.hWindow && !window.isStale &&
+           window.screenWidth == GetSystemMetrics(SM_CXSCREEN) &&
+           window.screenHeight == GetSystemMetrics(SM_CYSCREEN);
+}
 
-    LoadHistory(*activeCtx);
-    BackgroundCrawl();
+void InitializeLauncher() {
+    auto origin = std::chrono::steady_clock::now();
+    std::vector<StageTiming> timings;
+
+    RunStartupStage("storage", origin, timings, [] {
+        SetUpStoragePath();
+    });
+    RunStartupStage("history", origin, timings, [] {
+        historyJournal.Start();
+
+        std::vector<LauncherModeSpec> registry = LauncherModeRegistry();
+        launcherContexts.resize(registry.size());
+        for (size_t i = 0; i < registry.size(); ++i) {
+            LauncherContext& ctx = launcherContexts[i];
+            ctx.spec = std::move(registry[i]);
+            ctx.historyFileName = ctx.spec.historyName + ".txt";
+            ctx.journalFileName = ctx.spec.historyName + ".journal";
+            LoadHistory(ctx);
+        }
+
+        hLauncherBgBrush = CreateSolidBrush(RGB(30, 30, 30));
+        hEditBgBrush = CreateSolidBrush(RGB(30, 30, 30));
+        hScrollThumbBrush = CreateSolidBrush(RGB(70, 70, 70));
+        hSelectionBitmap = CreateTintBitmap(100, 100, 100, 128);
+    });
+    RunStartupStage("windows", origin, timings, [] {
+        for (auto& ctx : launcherContexts) BuildLauncherWindow(ctx);
+    });
+    RunStartupStage("indexSnapshot", origin, timings, [] {
+        LoadIndexSnapshot();
+        StartMatchWorker();
+    });
+
+    startupThread = std::thread(RunStartupPipeline, origin, std::move(timings));
+}
+
+void ShowLauncher(const std::string& name) {
+    if (hLauncherWindow) return;
+    showStart = std::chrono::steady_clock::now();
+
+    activeCtx = FindLauncherContext(name);
+    if (!activeCtx) return;
+
+    isShowRebuilt = !IsLauncherWindowCurrent(activeCtx->window);
+    if (isShowRebuilt) BuildLauncherWindow(*activeCtx);
+    const LauncherWindow& window = activeCtx->window;
+    hEdit = window.hEdit;
+    hResultList = window.hResultList;
+    hPathLabel = window.hPathLabel;
+    resultRowHeight = window.rowHeight;
+
+    // Cleared before the window counts as shown, so the EN_CHANGE this
+    // sends does not start a query of its own.
+    SetWindowTextA(hEdit, "");
+    SetWindowTextA(hPathLabel, "");
+    EnableWindow(hEdit, !IsEngineMissing());
+    hLauncherWindow = window.hWindow;
+
+    RebuildHistorySnapshot(*activeCtx);
+    if (IsConsistencyCrawlDue()) BackgroundCrawl();
+    else CrawlUnwatchedRoots();
     RefreshMatches("");
+    isShowTimed = true;
 
     AllowSetForegroundWindow(ASFW_ANY);
     keybd_event(0xFC, 0, 0, 0);
@@ -920,21 +2182,58 @@ void ShowLauncher(LauncherMode mode) {
     ShowWindow(hLauncherWindow, SW_SHOW);
     SetForegroundWindow(hLauncherWindow);
     SetActiveWindow(hLauncherWindow);
-    if (!activeCtx->isEngineFound) {
+    if (IsEngineMissing()) {
         SetFocus(hLauncherWindow);
     } else {
         SetFocus(hEdit);
     }
 }
 
+// The stop flag skips every later stage and ends the wsl.exe wait and the
+// home folder listing. A file system call stuck on a WSL share is woken
+// by cancelling the thread's synchronous I/O, repeated until the pipeline
+// has finished, so the thread is always joined before the globals it
+// touches are torn down.
+static void StopStartupPipeline() {
+    if (!startupThread.joinable()) return;
+    isStartupCancelled = true;
+    while (!isStartupFinished) {
+        HANDLE thread = hStartupThread;
+        if (thread) CancelSynchronousIo(thread);
+        Sleep(10);
+    }
+    startupThread.join();
+    HANDLE thread = hStartupThread.exchange(NULL);
+    if (thread) CloseHandle(thread);
+}
+
 void ReleaseLauncherResources() {
-    if (ctxVSCode.logoImage) {
-        delete ctxVSCode.logoImage;
-        ctxVSCode.logoImage = nullptr;
+    StopStartupPipeline();
+    StopMatchWorker();
+    StopFolderWatcher();
+    StopLaunchTimer();
+    historyJournal.Stop();
+    HideLauncher();
+    for (auto& ctx : launcherContexts) DestroyLauncherWindow(ctx);
+    if (!indexBaseDir.empty()) SavePerfSnapshot();
+    {
+        std::lock_guard<std::mutex> lock(indexWriteMutex);
+        if (isSnapshotStale) SaveIndexSnapshot(*CurrentCrawledIndex());
+    }
+
+    for (auto& ctx : launcherContexts) ReleaseFadedLogo(ctx);
+    ReleaseBackBuffer();
+    if (hSpriteDC) {
+        DeleteDC(hSpriteDC);
+        hSpriteDC = NULL;
+    }
+    if (hSelectionBitmap) {
+        DeleteObject(hSelectionBitmap);
+        hSelectionBitmap = NULL;
     }
-    if (ctxWSL.logoImage) {
-        delete ctxWSL.logoImage;
-        ctxWSL.logoImage = nullptr;
+    if (hScrollThumbBrush) {
+        DeleteObject(hScrollThumbBrush);
+        hScrollThumbBrush = NULL;
     }
 
     if (hGlobalFont) {
@@ -47,13 +47,11 @@ LRESULT CALLBACK KeyboardProc(int nCode, WPARAM wParam, LPARAM lParam) {
 
         if (isDown) {
             if (ctrlHeld && altHeld) {
-                if (Config::enableVSCodeLauncher && pKeyBoard->vkCode == Config::VSCodeLauncherKey) {
-                    ShowLauncher(LauncherMode::VSCode);
-                    return 1;
-                }
-                if (Config::enableWSLTerminalLauncher && pKeyBoard->vkCode == Config::WSLTerminalLauncherKey) {
-                    ShowLauncher(LauncherMode::WSL);
-                    return 1;
+                for (const auto& launcher : Config::launchers) {
+                    if (launcher.enabled && pKeyBoard->vkCode == launcher.key) {
+                        ShowLauncher(launcher.name);
+                        return 1;
+                    }
                 }
                 if (pKeyBoard->vkCode == 'Q') {
                     InitiateQuitSequence();
@@ -140,17 +138,23 @@ int main() {
     HWND hGhostWnd = CreateWindowA(wc.lpszClassName, "KinesisGhost", 0, 0, 0, 0, 0, NULL, NULL, GetModuleHandle(NULL), NULL);
     if (hGhostWnd == NULL) return 0;
 
-    HHOOK hhkLowLevelKybd = SetWindowsHookEx(WH_KEYBOARD_LL, KeyboardProc, GetModuleHandle(NULL), 0);
-    if (hhkLowLevelKybd == NULL) {
-        std::cerr << "failed to install hook" << std::endl;
-        return 1;
-    }
-
     Gdiplus::GdiplusStartupInput gdiplusStartupInput;
     ULONG_PTR gdiplusToken;
     Gdiplus::GdiplusStartup(&gdiplusToken, &gdiplusStartupInput, NULL);
     Config::LoadConfig();    
     InitializeLauncher();
+
+    // Installed once the UI thread's own startup work is done, so from the
+    // first keystroke the hook runs on a thread that is pumping messages
+    // and never holds up keyboard input system-wide.
+    HHOOK hhkLowLevelKybd = SetWindowsHookEx(WH_KEYBOARD_LL, KeyboardProc, GetModuleHandle(NULL), 0);
+    if (hhkLowLevelKybd == NULL) {
+        std::cerr << "failed to install hook" << std::endl;
+        ReleaseLauncherResources();
+        Gdiplus::GdiplusShutdown(gdiplusToken);
+        SystemState::CleanUp();
+        return 1;
+    }
     
     MSG msg;
     while (GetMessage(&msg, NULL, 0, 0)) {
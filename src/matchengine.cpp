@@ -0,0 +1,174 @@
+#include "matchengine.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+static const size_t idsPerChunk = 256 * FolderIndex::blockSize;
+static const unsigned int maxMatchThreads = 8;
+
+// A chunk is a run of positions into either the id space or the filtered
+// candidate list. Chunks never straddle a view range.
+struct MatchChunk {
+    size_t begin;
+    size_t end;
+};
+
+// Helper threads are started on first use and then parked between calls,
+// so a keystroke pays for a wake-up instead of creating and joining its
+// threads. Calls are serialized; the match worker is the only regular
+// caller. The pool is never destroyed, since joining parked threads from
+// a static destructor at process exit is not safe on Windows.
+class MatchPool {
+public:
+    static MatchPool& Instance() {
+        static MatchPool* pool = new MatchPool();
+        return *pool;
+    }
+
+    // Runs work(1) to work(helpers) on the pool and work(0) on the calling
+    // thread, and returns once all of them are done.
+    void Run(unsigned int helpers, const std::function<void(unsigned int)>& work) {
+        std::lock_guard<std::mutex> runLock(runMutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            while (threads.size() < helpers) {
+                unsigned int slot = (unsigned int)threads.size() + 1;
+                threads.emplace_back([this, slot] { Loop(slot); });
+                threads.back().detach();
+            }
+            job = &work;
+            activeHelpers = helpers;
+            remaining = helpers;
+            ++generation;
+        }
+        wake.notify_all();
+        work(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return remaining == 0; });
+        job = nullptr;
+    }
+
+private:
+    void Loop(unsigned int slot) {
+        uint64_t seen = 0;
+        while (true) {
+            const std::function<void(unsigned int)>* current;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return generation != seen; });
+                seen = generation;
+                if (slot > activeHelpers) continue;
+                current = job;
+            }
+            (*current)(slot);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--remaining == 0) done.notify_one();
+        }
+    }
+
+    std::mutex runMutex;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::vector<std::thread> threads;
+    const std::function<void(unsigned int)>* job = nullptr;
+    unsigned int activeHelpers = 0;
+    unsigned int remaining = 0;
+    uint64_t generation = 0;
+};
+
+static unsigned int MatchThreadCount(unsigned int requested, size_t chunkCount) {
+    unsigned int threads = requested;
+    if (threads == 0) threads = std::min(std::max(std::thread::hardware_concurrency(), 1u), maxMatchThreads);
+    return (unsigned int)std::max<size_t>(1, std::min<size_t>(threads, chunkCount));
+}
+
+void MatchIndex(const FolderIndex& index, const std::vector<IdRange>& view, const std::vector<uint32_t>* candidates,
+                const IndexMatchOptions& options, IndexMatchResult& result) {
+    result = IndexMatchResult();
+
+    std::vector<uint32_t> ids;
+    std::vector<MatchChunk> chunks;
+    if (candidates) {
+        size_t r = 0;
+        for (uint32_t id : *candidates) {
+            while (r < view.size() && view[r].end <= id) ++r;
+            if (r == view.size()) break;
+            if (id >= view[r].begin) ids.push_back(id);
+        }
+        for (size_t begin = 0; begin < ids.size(); begin += idsPerChunk) {
+            chunks.push_back({ begin, std::min(begin + idsPerChunk, ids.size()) });
+        }
+    } else {
+        for (const auto& range : view) {
+            for (size_t begin = range.begin; begin < range.end; begin += idsPerChunk) {
+                chunks.push_back({ begin, std::min<size_t>(begin + idsPerChunk, range.end) });
+            }
+        }
+    }
+
+    uint64_t patternMask = CharMask(options.lowerPattern);
+    unsigned int threadCount = MatchThreadCount(options.threadCount, chunks.size());
+    std::vector<TopMatches> tops(threadCount, TopMatches(options.limit));
+    std::vector<size_t> visits(threadCount, 0);
+    std::vector<std::vector<uint32_t>> chunkSurvivors(chunks.size());
+    std::atomic<size_t> nextChunk(0);
+    std::atomic<bool> cancelled(false);
+
+    std::function<void(unsigned int)> work = [&](unsigned int slot) {
+        FolderIndex::Decoder decoder(index);
+        TopMatches& top = tops[slot];
+        size_t visited = 0;
+        size_t c;
+        while (!cancelled && (c = nextChunk.fetch_add(1)) < chunks.size()) {
+            std::vector<uint32_t>& survivors = chunkSurvivors[c];
+            for (size_t k = chunks[c].begin; k < chunks[c].end; ++k) {
+                if ((++visited & 1023) == 0 && (cancelled || (options.isCancelled && options.isCancelled()))) {
+                    cancelled = true;
+                    break;
+                }
+                uint32_t id = candidates ? ids[k] : (uint32_t)k;
+                if (!CouldMatch(patternMask, index.BlockCharMask(id / FolderIndex::blockSize))) {
+                    // A rejected block is skipped whole without decoding it.
+                    if (!candidates) k = std::min<size_t>((id / FolderIndex::blockSize + 1) * FolderIndex::blockSize, chunks[c].end) - 1;
+                    continue;
+                }
+                decoder.Seek(id);
+                std::string_view path = decoder.Path();
+                int score;
+                bool isMatch = options.exact
+                    ? ExactMatch(options.lowerPattern, path, decoder.LowerPath(), decoder.BasenameOffset(), score)
+                    : FuzzyMatch(options.lowerPattern, path, decoder.LowerPath(), decoder.BasenameOffset(), score);
+                if (!isMatch) continue;
+                survivors.push_back(id);
+                if (options.isExcluded && options.isExcluded(path)) continue;
+                top.Offer(score, id, (uint32_t)path.size());
+            }
+        }
+        visits[slot] = visited;
+    };
+
+    if (threadCount > 1) MatchPool::Instance().Run(threadCount - 1, work);
+    else work(0);
+
+    for (size_t visited : visits) result.visited += visited;
+    if (cancelled) {
+        result.cancelled = true;
+        return;
+    }
+
+    TopMatches merged(options.limit);
+    for (const auto& top : tops) merged.Merge(top);
+    result.best = merged.Sorted();
+
+    size_t survivorCount = 0;
+    for (const auto& survivors : chunkSurvivors) survivorCount += survivors.size();
+    result.survivors.reserve(survivorCount);
+    for (const auto& survivors : chunkSurvivors) {
+        result.survivors.insert(result.survivors.end(), survivors.begin(), survivors.end());
+    }
+}
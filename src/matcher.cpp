@@ -0,0 +1,218 @@
+#include "matcher.hpp"
+#include "substring.hpp"
+
+#include <algorithm>
+#include <array>
+
+enum CharClass : uint8_t {
+    CharWhite,
+    CharNonWord,
+    CharDelimiter,
+    CharLower,
+    CharUpper,
+    CharNumber
+};
+
+static const int scoreMatch = 16;
+static const int scoreGapStart = -3;
+static const int scoreGapExtension = -1;
+static const int bonusBoundary = scoreMatch / 2;
+static const int bonusBoundaryWhite = bonusBoundary + 2;
+static const int bonusBoundaryDelimiter = bonusBoundary + 1;
+static const int bonusNonWord = scoreMatch / 2;
+static const int bonusCamel123 = bonusBoundary + scoreGapExtension;
+static const int bonusConsecutive = -(scoreGapStart + scoreGapExtension);
+static const int bonusFirstCharMultiplier = 2;
+static const int bonusBasename = 4;
+static const size_t maxCandidateLevels = 32;
+
+struct CharTables {
+    std::array<unsigned char, 256> lower;
+    std::array<CharClass, 256> charClass;
+    std::array<uint64_t, 256> maskBit;
+
+    CharTables() {
+        for (int c = 0; c < 256; ++c) {
+            lower[c] = (c >= 'A' && c <= 'Z') ? (unsigned char)(c - 'A' + 'a') : (unsigned char)c;
+            if (c >= 'a' && c <= 'z')                          charClass[c] = CharLower;
+            else if (c >= 'A' && c <= 'Z')                     charClass[c] = CharUpper;
+            else if (c >= '0' && c <= '9')                     charClass[c] = CharNumber;
+            else if (c == ' ' || c == '\t')                    charClass[c] = CharWhite;
+            else if (c == '\\' || c == '/' || c == ':' ||
+                     c == ';' || c == ',' || c == '|')         charClass[c] = CharDelimiter;
+            else if (c >= 0x80)                                charClass[c] = CharLower;
+            else                                               charClass[c] = CharNonWord;
+
+            if (c >= 'a' && c <= 'z')      maskBit[c] = 1ull << (c - 'a');
+            else if (c >= '0' && c <= '9') maskBit[c] = 1ull << (26 + c - '0');
+            else                           maskBit[c] = 1ull << (36 + c % 28);
+        }
+    }
+};
+
+static const CharTables tables;
+
+static int BonusFor(CharClass prevClass, CharClass charClass) {
+    if (charClass > CharNonWord) {
+        if (prevClass == CharWhite)     return bonusBoundaryWhite;
+        if (prevClass == CharDelimiter) return bonusBoundaryDelimiter;
+        if (prevClass == CharNonWord)   return bonusBoundary;
+    }
+    if ((prevClass == CharLower && charClass == CharUpper) || (prevClass != CharNumber && charClass == CharNumber)) {
+        return bonusCamel123;
+    }
+    if (charClass == CharNonWord || charClass == CharDelimiter) return bonusNonWord;
+    if (charClass == CharWhite) return bonusBoundaryWhite;
+    return 0;
+}
+
+static bool FindWindow(std::string_view pattern, std::string_view lowerText, size_t from, size_t& sidx, size_t& eidx) {
+    size_t pidx = 0;
+    size_t start = lowerText.size();
+    for (size_t i = from; i < lowerText.size(); ++i) {
+        if (lowerText[i] == pattern[pidx]) {
+            if (pidx == 0) start = i;
+            if (++pidx == pattern.size()) {
+                eidx = i + 1;
+                break;
+            }
+        }
+    }
+    if (pidx != pattern.size()) return false;
+
+    for (size_t i = eidx; i-- > start;) {
+        if (lowerText[i] == pattern[pidx - 1]) {
+            if (--pidx == 0) {
+                sidx = i;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+static int ScoreWindow(std::string_view pattern, std::string_view text, std::string_view lowerText, size_t sidx, size_t eidx) {
+    int score = 0;
+    int consecutive = 0;
+    int firstBonus = 0;
+    bool inGap = false;
+    size_t pidx = 0;
+    CharClass prevClass = sidx > 0 ? tables.charClass[(unsigned char)text[sidx - 1]] : CharDelimiter;
+
+    for (size_t i = sidx; i < eidx; ++i) {
+        CharClass charClass = tables.charClass[(unsigned char)text[i]];
+        if (pidx < pattern.size() && lowerText[i] == pattern[pidx]) {
+            score += scoreMatch;
+            int bonus = BonusFor(prevClass, charClass);
+            if (consecutive == 0) {
+                firstBonus = bonus;
+            } else {
+                if (bonus >= bonusBoundary && bonus > firstBonus) firstBonus = bonus;
+                bonus = std::max(std::max(bonus, firstBonus), bonusConsecutive);
+            }
+            score += (pidx == 0) ? bonus * bonusFirstCharMultiplier : bonus;
+            inGap = false;
+            ++consecutive;
+            ++pidx;
+        } else {
+            score += inGap ? scoreGapExtension : scoreGapStart;
+            inGap = true;
+            consecutive = 0;
+            firstBonus = 0;
+        }
+        prevClass = charClass;
+    }
+    return score;
+}
+
+std::string LowerPattern(std::string_view pattern) {
+    std::string lowerPattern(pattern);
+    for (auto& c : lowerPattern) c = (char)tables.lower[(unsigned char)c];
+    return lowerPattern;
+}
+
+uint64_t CharMask(std::string_view lowerText) {
+    uint64_t mask = 0;
+    for (char c : lowerText) mask |= tables.maskBit[(unsigned char)c];
+    return mask;
+}
+
+bool ExactMatch(std::string_view lowerPattern, std::string_view text, std::string_view lowerText,
+                size_t basenameOffset, int& score) {
+    score = 0;
+    if (lowerPattern.empty()) return true;
+
+    int basenameBonus = 0;
+    size_t pos = FindSubstring(lowerText, lowerPattern, basenameOffset);
+    if (pos != std::string_view::npos) {
+        basenameBonus = bonusBasename * (int)lowerPattern.size();
+    } else {
+        pos = FindSubstring(lowerText, lowerPattern);
+        if (pos == std::string_view::npos) return false;
+    }
+    score = ScoreWindow(lowerPattern, text, lowerText, pos, pos + lowerPattern.size()) + basenameBonus;
+    return true;
+}
+
+bool FuzzyMatch(std::string_view lowerPattern, std::string_view text, std::string_view lowerText,
+                size_t basenameOffset, int& score) {
+    score = 0;
+    if (lowerPattern.empty()) return true;
+
+    size_t sidx = 0;
+    size_t eidx = 0;
+    if (!FindWindow(lowerPattern, lowerText, 0, sidx, eidx)) return false;
+    score = ScoreWindow(lowerPattern, text, lowerText, sidx, eidx);
+
+    int basenameBonus = bonusBasename * (int)lowerPattern.size();
+    if (sidx >= basenameOffset) {
+        score += basenameBonus;
+    } else if (FindWindow(lowerPattern, lowerText, basenameOffset, sidx, eidx)) {
+        score = std::max(score, ScoreWindow(lowerPattern, text, lowerText, sidx, eidx) + basenameBonus);
+    }
+    return true;
+}
+
+static bool IsBetter(const ScoredMatch& a, const ScoredMatch& b) {
+    if (a.score != b.score) return a.score > b.score;
+    if (a.length != b.length) return a.length < b.length;
+    return a.id < b.id;
+}
+
+void TopMatches::Offer(int score, uint32_t id, uint32_t length) {
+    if (limit == 0) return;
+    ScoredMatch candidate { score, id, length };
+    if (heap.size() < limit) {
+        heap.push_back(candidate);
+        std::push_heap(heap.begin(), heap.end(), IsBetter);
+    } else if (IsBetter(candidate, heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), IsBetter);
+        heap.back() = candidate;
+        std::push_heap(heap.begin(), heap.end(), IsBetter);
+    }
+}
+
+void TopMatches::Merge(const TopMatches& other) {
+    for (const auto& match : other.heap) Offer(match.score, match.id, match.length);
+}
+
+std::vector<ScoredMatch> TopMatches::Sorted() const {
+    std::vector<ScoredMatch> sorted = heap;
+    std::sort(sorted.begin(), sorted.end(), IsBetter);
+    return sorted;
+}
+
+// Every path that matches a pattern also matches all of its prefixes, so the
+// survivors of the longest cached prefix are a complete candidate set.
+const std::vector<uint32_t>* CandidateCache::Narrow(std::string_view lowerPattern) {
+    while (!levels.empty() && lowerPattern.substr(0, levels.back().pattern.size()) != levels.back().pattern) {
+        levels.pop_back();
+    }
+    return levels.empty() ? nullptr : &levels.back().survivors;
+}
+
+void CandidateCache::Store(std::string_view lowerPattern, std::vector<uint32_t> survivors) {
+    if (!levels.empty() && levels.back().pattern == lowerPattern) return;
+    if (levels.size() >= maxCandidateLevels) levels.erase(levels.begin());
+    levels.push_back({ std::string(lowerPattern), std::move(survivors) });
+}
@@ -0,0 +1,136 @@
+#include "perfreport.hpp"
+#include "substring.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+void MatchPerf::Record(double elapsedMs, size_t candidates, size_t indexSize) {
+    ++queries;
+    totalMs += elapsedMs;
+    maxMs = std::max(maxMs, elapsedMs);
+    lastMs = elapsedMs;
+    lastCandidates = candidates;
+    lastIndexSize = indexSize;
+}
+
+void LaunchPerf::Record(double elapsedMs) {
+    ++launches;
+    totalMs += elapsedMs;
+    maxMs = std::max(maxMs, elapsedMs);
+    lastMs = elapsedMs;
+}
+
+void ShowPerf::Record(double elapsedMs, bool isRebuilt) {
+    ++shows;
+    if (isRebuilt) ++rebuilds;
+    if (elapsedMs > budgetMs) ++overBudget;
+    totalMs += elapsedMs;
+    maxMs = std::max(maxMs, elapsedMs);
+    lastMs = elapsedMs;
+}
+
+size_t PeakMemoryBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return (size_t)usage.ru_maxrss * 1024;
+#endif
+}
+
+static std::string EscapeJson(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '\\' || c == '"') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+bool SavePerfReport(const std::string& filePath, const CrawlPerf& crawl, const MatchPerf& match,
+                    const LaunchPerf& launch, const ShowPerf& show) {
+    std::ofstream file(filePath, std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    file << "{\n"
+         << "  \"crawl\": {\n"
+         << "    \"wallMs\": " << crawl.wallMs << ",\n"
+         << "    \"buildMs\": " << crawl.buildMs << ",\n"
+         << "    \"directories\": " << crawl.directories << ",\n"
+         << "    \"directoriesPerSecond\": " << (uint64_t)crawl.directoriesPerSecond << ",\n"
+         << "    \"indexBytes\": " << crawl.indexBytes << ",\n"
+         << "    \"roots\": [\n";
+    for (size_t i = 0; i < crawl.roots.size(); ++i) {
+        const CrawlRootStats& stat = crawl.roots[i];
+        file << "      { \"root\": \"" << EscapeJson(stat.root) << "\""
+             << ", \"entries\": " << stat.entries
+             << ", \"elapsedMs\": " << stat.elapsedMs
+             << ", \"depth\": " << stat.depth
+             << ", \"truncated\": " << (stat.truncated ? "true" : "false")
+             << ", \"timedOut\": " << (stat.timedOut ? "true" : "false")
+             << " }" << (i + 1 < crawl.roots.size() ? "," : "") << "\n";
+    }
+    file << "    ]\n"
+         << "  },\n"
+         << "  \"match\": {\n"
+         << "    \"queries\": " << match.queries << ",\n"
+         << "    \"averageMs\": " << (match.queries ? match.totalMs / match.queries : 0.0) << ",\n"
+         << "    \"maxMs\": " << match.maxMs << ",\n"
+         << "    \"lastMs\": " << match.lastMs << ",\n"
+         << "    \"lastCandidates\": " << match.lastCandidates << ",\n"
+         << "    \"lastIndexSize\": " << match.lastIndexSize << ",\n"
+         << "    \"substringKernel\": \"" << SubstringKernelName() << "\"\n"
+         << "  },\n"
+         << "  \"launch\": {\n"
+         << "    \"launches\": " << launch.launches << ",\n"
+         << "    \"timeouts\": " << launch.timeouts << ",\n"
+         << "    \"averageMs\": " << (launch.launches ? launch.totalMs / launch.launches : 0.0) << ",\n"
+         << "    \"maxMs\": " << launch.maxMs << ",\n"
+         << "    \"lastMs\": " << launch.lastMs << "\n"
+         << "  },\n"
+         << "  \"show\": {\n"
+         << "    \"shows\": " << show.shows << ",\n"
+         << "    \"rebuilds\": " << show.rebuilds << ",\n"
+         << "    \"budgetMs\": " << ShowPerf::budgetMs << ",\n"
+         << "    \"overBudget\": " << show.overBudget << ",\n"
+         << "    \"averageMs\": " << (show.shows ? show.totalMs / show.shows : 0.0) << ",\n"
+         << "    \"maxMs\": " << show.maxMs << ",\n"
+         << "    \"lastMs\": " << show.lastMs << "\n"
+         << "  },\n"
+         << "  \"peakMemoryBytes\": " << PeakMemoryBytes() << "\n"
+         << "}\n";
+    return file.good();
+}
+
+bool SaveStartupReport(const std::string& filePath, const std::vector<StageTiming>& stages) {
+    std::ofstream file(filePath, std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    file << "{\n"
+         << "  \"stages\": [\n";
+    for (size_t i = 0; i < stages.size(); ++i) {
+        file << "    { \"name\": \"" << EscapeJson(stages[i].name) << "\""
+             << ", \"startMs\": " << stages[i].startMs
+             << ", \"durationMs\": " << stages[i].durationMs
+             << " }" << (i + 1 < stages.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n"
+         << "}\n";
+    return file.good();
+}
@@ -0,0 +1,209 @@
+#include "spawn.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+std::string QuoteWindowsArgument(const std::string& argument) {
+    if (!argument.empty() && argument.find_first_of(" \t\n\v\"") == std::string::npos) return argument;
+
+    std::string quoted = "\"";
+    for (size_t i = 0; ; ++i) {
+        size_t backslashes = 0;
+        while (i < argument.size() && argument[i] == '\\') {
+            ++backslashes;
+            ++i;
+        }
+        if (i == argument.size()) {
+            quoted.append(backslashes * 2, '\\');
+            break;
+        }
+        if (argument[i] == '"') {
+            quoted.append(backslashes * 2 + 1, '\\');
+        } else {
+            quoted.append(backslashes, '\\');
+        }
+        quoted += argument[i];
+    }
+    quoted += '"';
+    return quoted;
+}
+
+std::string JoinWindowsArguments(const std::vector<std::string>& arguments) {
+    std::string joined;
+    for (const auto& argument : arguments) {
+        if (!joined.empty()) joined += ' ';
+        joined += QuoteWindowsArgument(argument);
+    }
+    return joined;
+}
+
+std::string BuildWindowsCommandLine(const SpawnRequest& request) {
+    std::string commandLine = QuoteWindowsArgument(request.executable);
+    if (!request.arguments.empty()) commandLine += ' ' + JoinWindowsArguments(request.arguments);
+    return commandLine;
+}
+
+static bool SameName(const std::string& a, const std::string& b, bool ignoreCase) {
+    if (a.size() != b.size()) return false;
+    if (!ignoreCase) return a == b;
+    return std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return std::tolower((unsigned char)x) == std::tolower((unsigned char)y);
+    });
+}
+
+std::vector<std::string> MergeEnvironment(const std::vector<std::string>& current,
+                                          const std::vector<std::pair<std::string, std::string>>& overrides,
+                                          bool ignoreCase) {
+    std::vector<std::string> merged;
+    merged.reserve(current.size() + overrides.size());
+    for (const auto& entry : current) {
+        // Windows keeps per-drive directories as "=C:=C:\...", so the name
+        // separator is searched for after the first character.
+        size_t separator = entry.find('=', 1);
+        std::string name = entry.substr(0, separator);
+        bool isOverridden = std::any_of(overrides.begin(), overrides.end(), [&](const auto& item) {
+            return SameName(item.first, name, ignoreCase);
+        });
+        if (!isOverridden) merged.push_back(entry);
+    }
+    for (const auto& item : overrides) {
+        if (!item.second.empty()) merged.push_back(item.first + "=" + item.second);
+    }
+    return merged;
+}
+
+#ifdef _WIN32
+static bool IsProcessElevated() {
+    HANDLE hToken = NULL;
+    if (!OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &hToken)) return false;
+    TOKEN_ELEVATION elevation;
+    DWORD size = 0;
+    bool isElevated = GetTokenInformation(hToken, TokenElevation, &elevation, sizeof(elevation), &size) &&
+                      elevation.TokenIsElevated != 0;
+    CloseHandle(hToken);
+    return isElevated;
+}
+
+static std::vector<std::string> CurrentEnvironment() {
+    std::vector<std::string> entries;
+    char* block = GetEnvironmentStringsA();
+    if (!block) return entries;
+    for (const char* entry = block; *entry; entry += strlen(entry) + 1) entries.push_back(entry);
+    FreeEnvironmentStringsA(block);
+    return entries;
+}
+
+class Win32ProcessSpawner : public ProcessSpawner {
+public:
+    uint32_t Spawn(const SpawnRequest& request) override {
+        std::string commandLine = BuildWindowsCommandLine(request);
+        std::vector<char> commandBuffer(commandLine.begin(), commandLine.end());
+        commandBuffer.push_back('\0');
+
+        std::vector<char> environmentBlock;
+        for (const auto& entry : MergeEnvironment(CurrentEnvironment(), request.environment, true)) {
+            environmentBlock.insert(environmentBlock.end(), entry.begin(), entry.end());
+            environmentBlock.push_back('\0');
+        }
+        environmentBlock.push_back('\0');
+
+        STARTUPINFOEXA si {};
+        si.StartupInfo.cb = sizeof(si);
+        si.StartupInfo.dwFlags = STARTF_USESHOWWINDOW;
+        si.StartupInfo.wShowWindow = request.hidden ? SW_HIDE : SW_SHOWNORMAL;
+        DWORD flags = request.hidden ? CREATE_NO_WINDOW : CREATE_NEW_CONSOLE;
+
+        // Parenting the child to the shell gives it Explorer's token, the
+        // same trick ShellExecute through the desktop window relies on.
+        HANDLE hParent = NULL;
+        std::vector<char> attributeBuffer;
+        if (IsProcessElevated()) {
+            DWORD shellProcessId = 0;
+            HWND hShell = GetShellWindow();
+            if (hShell) GetWindowThreadProcessId(hShell, &shellProcessId);
+            if (shellProcessId) hParent = OpenProcess(PROCESS_CREATE_PROCESS, FALSE, shellProcessId);
+            if (!hParent) return 0;
+
+            SIZE_T attributeSize = 0;
+            InitializeProcThreadAttributeList(NULL, 1, 0, &attributeSize);
+            attributeBuffer.resize(attributeSize);
+            si.lpAttributeList = (LPPROC_THREAD_ATTRIBUTE_LIST)attributeBuffer.data();
+            if (!InitializeProcThreadAttributeList(si.lpAttributeList, 1, 0, &attributeSize) ||
+                !UpdateProcThreadAttribute(si.lpAttributeList, 0, PROC_THREAD_ATTRIBUTE_PARENT_PROCESS,
+                                           &hParent, sizeof(hParent), NULL, NULL)) {
+                CloseHandle(hParent);
+                return 0;
+            }
+            si.StartupInfo.cb = sizeof(STARTUPINFOEXA);
+            flags |= EXTENDED_STARTUPINFO_PRESENT;
+        }
+
+        PROCESS_INFORMATION pi {};
+        BOOL created = CreateProcessA(request.executable.c_str(), commandBuffer.data(), NULL, NULL, FALSE, flags,
+                                      environmentBlock.data(), NULL, (LPSTARTUPINFOA)&si, &pi);
+        if (si.lpAttributeList) DeleteProcThreadAttributeList(si.lpAttributeList);
+        if (hParent) CloseHandle(hParent);
+        if (!created) return 0;
+
+        CloseHandle(pi.hThread);
+        CloseHandle(pi.hProcess);
+        return pi.dwProcessId;
+    }
+};
+
+std::unique_ptr<ProcessSpawner> CreateProcessSpawner() {
+    return std::make_unique<Win32ProcessSpawner>();
+}
+#else
+class PosixProcessSpawner : public ProcessSpawner {
+public:
+    uint32_t Spawn(const SpawnRequest& request) override {
+        std::vector<std::string> current;
+        for (char** entry = environ; *entry; ++entry) current.push_back(*entry);
+        std::vector<std::string> environment = MergeEnvironment(current, request.environment, false);
+
+        std::vector<char*> argv;
+        argv.push_back(const_cast<char*>(request.executable.c_str()));
+        for (const auto& argument : request.arguments) argv.push_back(const_cast<char*>(argument.c_str()));
+        argv.push_back(nullptr);
+
+        std::vector<char*> envp;
+        for (const auto& entry : environment) envp.push_back(const_cast<char*>(entry.c_str()));
+        envp.push_back(nullptr);
+
+        pid_t pid = 0;
+        if (posix_spawnp(&pid, request.executable.c_str(), NULL, NULL, argv.data(), envp.data()) != 0) return 0;
+
+        // Nobody waits for a launched program, so a detached waiter reaps it
+        // instead of leaving a zombie behind for every launch.
+        std::thread([pid] {
+            int status = 0;
+            while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+        }).detach();
+        return (uint32_t)pid;
+    }
+};
+
+std::unique_ptr<ProcessSpawner> CreateProcessSpawner() {
+    return std::make_unique<PosixProcessSpawner>();
+}
+#endif
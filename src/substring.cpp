@@ -0,0 +1,109 @@
+#include "substring.hpp"
+
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KINESIS_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+using FindKernel = size_t (*)(const char* text, size_t textLength, const char* pattern, size_t patternLength);
+
+// Callers guarantee 2 <= patternLength <= textLength.
+static size_t FindScalar(const char* text, size_t textLength, const char* pattern, size_t patternLength) {
+    const char* end = text + textLength - patternLength + 1;
+    for (const char* p = text; p < end;) {
+        p = (const char*)memchr(p, pattern[0], end - p);
+        if (!p) break;
+        if (memcmp(p + 1, pattern + 1, patternLength - 1) == 0) return p - text;
+        ++p;
+    }
+    return std::string_view::npos;
+}
+
+#ifdef KINESIS_X86_KERNELS
+// Every kernel checks `positions` candidate starts. The last partial block
+// is handled by one overlapping load that ends at the final position, with
+// the starts already checked masked off, so short paths need no scalar tail.
+__attribute__((target("sse2")))
+static size_t FindSse2(const char* text, size_t textLength, const char* pattern, size_t patternLength) {
+    const __m128i first = _mm_set1_epi8(pattern[0]);
+    const __m128i last = _mm_set1_epi8(pattern[patternLength - 1]);
+    size_t positions = textLength - patternLength + 1;
+    if (positions < 16) return FindScalar(text, textLength, pattern, patternLength);
+
+    for (size_t i = 0; i < positions; i += 16) {
+        size_t start = i + 16 <= positions ? i : positions - 16;
+        __m128i blockFirst = _mm_loadu_si128((const __m128i*)(text + start));
+        __m128i blockLast = _mm_loadu_si128((const __m128i*)(text + start + patternLength - 1));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast)));
+        mask &= ~((1u << (i - start)) - 1);
+        while (mask) {
+            unsigned int bit = (unsigned int)__builtin_ctz(mask);
+            if (memcmp(text + start + bit + 1, pattern + 1, patternLength - 2) == 0) return start + bit;
+            mask &= mask - 1;
+        }
+    }
+    return std::string_view::npos;
+}
+
+__attribute__((target("avx2")))
+static size_t FindAvx2(const char* text, size_t textLength, const char* pattern, size_t patternLength) {
+    const __m256i first = _mm256_set1_epi8(pattern[0]);
+    const __m256i last = _mm256_set1_epi8(pattern[patternLength - 1]);
+    size_t positions = textLength - patternLength + 1;
+    if (positions < 32) return FindSse2(text, textLength, pattern, patternLength);
+
+    for (size_t i = 0; i < positions; i += 32) {
+        size_t start = i + 32 <= positions ? i : positions - 32;
+        __m256i blockFirst = _mm256_loadu_si256((const __m256i*)(text + start));
+        __m256i blockLast = _mm256_loadu_si256((const __m256i*)(text + start + patternLength - 1));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast)));
+        mask &= ~((1u << (i - start)) - 1);
+        while (mask) {
+            unsigned int bit = (unsigned int)__builtin_ctz(mask);
+            if (memcmp(text + start + bit + 1, pattern + 1, patternLength - 2) == 0) return start + bit;
+            mask &= mask - 1;
+        }
+    }
+    return std::string_view::npos;
+}
+#endif
+
+struct SubstringKernel {
+    FindKernel find = FindScalar;
+    const char* name = "scalar";
+
+    SubstringKernel() {
+#ifdef KINESIS_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            find = FindAvx2;
+            name = "avx2";
+        } else if (__builtin_cpu_supports("sse2")) {
+            find = FindSse2;
+            name = "sse2";
+        }
+#endif
+    }
+};
+
+static const SubstringKernel kernel;
+
+size_t FindSubstring(std::string_view text, std::string_view pattern, size_t from) {
+    if (from > text.size()) return std::string_view::npos;
+    if (pattern.empty()) return from;
+    if (pattern.size() > text.size() - from) return std::string_view::npos;
+    if (pattern.size() == 1) {
+        const void* found = memchr(text.data() + from, pattern[0], text.size() - from);
+        return found ? (const char*)found - text.data() : std::string_view::npos;
+    }
+    size_t found = kernel.find(text.data() + from, text.size() - from, pattern.data(), pattern.size());
+    return found == std::string_view::npos ? found : from + found;
+}
+
+const char* SubstringKernelName() {
+    return kernel.name;
+}
@@ -0,0 +1,369 @@
+#include "watcher.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Tests every folder on the way from the root down to the changed one, so
+// a whole excluded tree (an npm install, a cargo build) stays silent.
+static bool IsExcludedBelow(const ExcludeRules& excludes, const std::string& root,
+                            const std::string& relative, char separator) {
+    if (excludes.Empty()) return false;
+    std::string path = root;
+    size_t start = 0;
+    while (start < relative.size()) {
+        size_t end = relative.find(separator, start);
+        if (end == std::string::npos) end = relative.size();
+        std::string name = relative.substr(start, end - start);
+        if (!path.empty() && path.back() != separator) path += separator;
+        path += name;
+        if (excludes.Matches(name, path, root)) return true;
+        start = end + 1;
+    }
+    return false;
+}
+
+class EventBatch {
+public:
+    EventBatch(unsigned int settleMs, unsigned int maxDelayMs) : settle(settleMs), maxDelay(maxDelayMs) {}
+
+    void Add(FolderChange change, std::string path) {
+        auto now = std::chrono::steady_clock::now();
+        if (events.empty()) first = now;
+        last = now;
+        events.push_back({ change, std::move(path) });
+    }
+
+    // Milliseconds until the batch is due, or -1 while it is empty.
+    int TimeoutMs() const {
+        if (events.empty()) return -1;
+        auto now = std::chrono::steady_clock::now();
+        auto due = std::min(last + settle, first + maxDelay);
+        if (due <= now) return 0;
+        return (int)std::chrono::duration_cast<std::chrono::milliseconds>(due - now).count() + 1;
+    }
+
+    void DeliverIfDue(const FolderEventCallback& onEvents) {
+        if (TimeoutMs() != 0) return;
+        std::vector<FolderEvent> ready;
+        ready.swap(events);
+        onEvents(ready);
+    }
+
+private:
+    std::chrono::milliseconds settle;
+    std::chrono::milliseconds maxDelay;
+    std::chrono::steady_clock::time_point first;
+    std::chrono::steady_clock::time_point last;
+    std::vector<FolderEvent> events;
+};
+
+#ifdef _WIN32
+static std::string NarrowName(const WCHAR* name, int length) {
+    int size = WideCharToMultiByte(CP_ACP, 0, name, length, NULL, 0, NULL, NULL);
+    std::string narrow(size, '\0');
+    WideCharToMultiByte(CP_ACP, 0, name, length, &narrow[0], size, NULL, NULL);
+    return narrow;
+}
+
+// The 9P server behind \\wsl$ accepts ReadDirectoryChangesW but never
+// completes it, so such a root would look watched and stay silent.
+static bool IsWslShare(const std::string& root) {
+    return _strnicmp(root.c_str(), "\\\\wsl$\\", 7) == 0 || _strnicmp(root.c_str(), "\\\\wsl.localhost\\", 16) == 0;
+}
+
+// One overlapped ReadDirectoryChangesW per root with bWatchSubtree set, so
+// each root costs a single handle however deep it is.
+class Win32DirectoryWatcher : public DirectoryWatcher {
+public:
+    ~Win32DirectoryWatcher() override { Stop(); }
+
+    bool Start(const std::vector<std::string>& roots, const ExcludeRules& excludes,
+               FolderEventCallback onEvents) override {
+        Stop();
+        rules = excludes;
+        callback = std::move(onEvents);
+        stopEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+        unwatchedRoots.clear();
+
+        for (const auto& root : roots) {
+            if (watches.size() >= MAXIMUM_WAIT_OBJECTS - 1 || IsWslShare(root)) {
+                unwatchedRoots.push_back(root);
+                continue;
+            }
+            HANDLE hDir = CreateFileA(root.c_str(), FILE_LIST_DIRECTORY,
+                                      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+                                      OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+            if (hDir == INVALID_HANDLE_VALUE) {
+                unwatchedRoots.push_back(root);
+                continue;
+            }
+
+            auto watch = std::make_unique<Watch>();
+            watch->root = root;
+            watch->hDir = hDir;
+            watch->overlapped.hEvent = CreateEventA(NULL, FALSE, FALSE, NULL);
+            if (Arm(*watch)) {
+                watches.push_back(std::move(watch));
+            } else {
+                CloseHandle(watch->overlapped.hEvent);
+                CloseHandle(hDir);
+                unwatchedRoots.push_back(root);
+            }
+        }
+        if (watches.empty()) {
+            Stop();
+            return false;
+        }
+        worker = std::thread(&Win32DirectoryWatcher::Run, this);
+        return true;
+    }
+
+    void Stop() override {
+        if (stopEvent) SetEvent(stopEvent);
+        if (worker.joinable()) worker.join();
+        for (auto& watch : watches) {
+            DWORD bytes = 0;
+            if (CancelIoEx(watch->hDir, &watch->overlapped)) {
+                GetOverlappedResult(watch->hDir, &watch->overlapped, &bytes, TRUE);
+            }
+            CloseHandle(watch->overlapped.hEvent);
+            CloseHandle(watch->hDir);
+        }
+        watches.clear();
+        if (stopEvent) {
+            CloseHandle(stopEvent);
+            stopEvent = NULL;
+        }
+    }
+
+private:
+    struct Watch {
+        std::string root;
+        HANDLE hDir = INVALID_HANDLE_VALUE;
+        OVERLAPPED overlapped = {};
+        DWORD buffer[16384];
+    };
+
+    bool Arm(Watch& watch) {
+        return ReadDirectoryChangesW(watch.hDir, watch.buffer, sizeof(watch.buffer), TRUE,
+                                     FILE_NOTIFY_CHANGE_DIR_NAME, NULL, &watch.overlapped, NULL) != 0;
+    }
+
+    void Collect(Watch& watch, DWORD bytes, EventBatch& batch) {
+        if (bytes == 0) {
+            batch.Add(FolderChange::Overflow, watch.root);
+            return;
+        }
+        const BYTE* cursor = (const BYTE*)watch.buffer;
+        while (true) {
+            const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*)cursor;
+            std::string relative = NarrowName(info->FileName, (int)(info->FileNameLength / sizeof(WCHAR)));
+            if (!IsExcludedBelow(rules, watch.root, relative, '\\')) {
+                std::string path = watch.root;
+                if (path.back() != '\\') path += '\\';
+                path += relative;
+                switch (info->Action) {
+                    case FILE_ACTION_ADDED:
+                    case FILE_ACTION_RENAMED_NEW_NAME:
+                        batch.Add(FolderChange::Added, std::move(path));
+                        break;
+                    case FILE_ACTION_REMOVED:
+                    case FILE_ACTION_RENAMED_OLD_NAME:
+                        batch.Add(FolderChange::Removed, std::move(path));
+                        break;
+                }
+            }
+            if (info->NextEntryOffset == 0) break;
+            cursor += info->NextEntryOffset;
+        }
+    }
+
+    void Run() {
+        std::vector<HANDLE> handles { stopEvent };
+        for (auto& watch : watches) handles.push_back(watch->overlapped.hEvent);
+
+        EventBatch batch(settleMs, maxDelayMs);
+        while (true) {
+            int timeout = batch.TimeoutMs();
+            DWORD signaled = WaitForMultipleObjects((DWORD)handles.size(), handles.data(), FALSE,
+                                                    timeout < 0 ? INFINITE : (DWORD)timeout);
+            if (signaled == WAIT_OBJECT_0) return;
+            if (signaled > WAIT_OBJECT_0 && signaled < WAIT_OBJECT_0 + handles.size()) {
+                Watch& watch = *watches[signaled - WAIT_OBJECT_0 - 1];
+                DWORD bytes = 0;
+                if (GetOverlappedResult(watch.hDir, &watch.overlapped, &bytes, FALSE)) {
+                    Collect(watch, bytes, batch);
+                } else {
+                    batch.Add(FolderChange::Overflow, watch.root);
+                }
+                if (!Arm(watch)) batch.Add(FolderChange::Overflow, watch.root);
+            } else if (signaled != WAIT_TIMEOUT) {
+                return;
+            }
+            batch.DeliverIfDue(callback);
+        }
+    }
+
+    ExcludeRules rules;
+    FolderEventCallback callback;
+    HANDLE stopEvent = NULL;
+    std::vector<std::unique_ptr<Watch>> watches;
+    std::thread worker;
+};
+
+std::unique_ptr<DirectoryWatcher> CreateDirectoryWatcher() {
+    return std::make_unique<Win32DirectoryWatcher>();
+}
+#else
+// inotify watches single directories, so every folder below the roots gets
+// its own watch, and folders created later are added as they appear.
+class InotifyDirectoryWatcher : public DirectoryWatcher {
+public:
+    ~InotifyDirectoryWatcher() override { Stop(); }
+
+    bool Start(const std::vector<std::string>& roots, const ExcludeRules& excludes,
+               FolderEventCallback onEvents) override {
+        Stop();
+        rules = excludes;
+        callback = std::move(onEvents);
+        unwatchedRoots = roots;
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyFd < 0 || pipe(stopPipe) != 0) {
+            Stop();
+            return false;
+        }
+
+        unwatchedRoots.clear();
+        for (const auto& root : roots) {
+            if (!AddTree(root, root)) unwatchedRoots.push_back(root);
+        }
+        if (watchedPaths.empty()) {
+            Stop();
+            return false;
+        }
+        worker = std::thread(&InotifyDirectoryWatcher::Run, this);
+        return true;
+    }
+
+    void Stop() override {
+        if (stopPipe[1] >= 0) {
+            char signal = 0;
+            if (write(stopPipe[1], &signal, 1) < 0) {}
+        }
+        if (worker.joinable()) worker.join();
+        for (int& fd : stopPipe) {
+            if (fd >= 0) close(fd);
+            fd = -1;
+        }
+        if (inotifyFd >= 0) close(inotifyFd);
+        inotifyFd = -1;
+        watchedPaths.clear();
+    }
+
+private:
+    struct WatchedPath {
+        std::string root;
+        std::string path;
+    };
+
+    // False when path itself could not be watched.
+    bool AddTree(const std::string& root, const std::string& path) {
+        int wd = inotify_add_watch(inotifyFd, path.c_str(),
+                                   IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+        if (wd < 0) return false;
+        watchedPaths[wd] = { root, path };
+
+        DIR* dir = opendir(path.c_str());
+        if (!dir) return true;
+        while (dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] == '.') continue;
+            std::string child = path + "/" + entry->d_name;
+            bool isDirectory = entry->d_type == DT_DIR;
+            if (entry->d_type == DT_UNKNOWN) {
+                struct stat st;
+                isDirectory = lstat(child.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+            }
+            if (isDirectory && !rules.Matches(entry->d_name, child, root)) AddTree(root, child);
+        }
+        closedir(dir);
+        return true;
+    }
+
+    void Collect(EventBatch& batch) {
+        alignas(inotify_event) char buffer[16384];
+        while (true) {
+            ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+            if (length <= 0) return;
+            for (char* cursor = buffer; cursor < buffer + length;) {
+                const inotify_event* event = (const inotify_event*)cursor;
+                cursor += sizeof(inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    for (const auto& watched : watchedPaths) batch.Add(FolderChange::Overflow, watched.second.root);
+                    continue;
+                }
+                if (event->mask & IN_IGNORED) {
+                    watchedPaths.erase(event->wd);
+                    continue;
+                }
+                auto found = watchedPaths.find(event->wd);
+                if (found == watchedPaths.end() || !(event->mask & IN_ISDIR) || event->len == 0) continue;
+                if (event->name[0] == '.') continue;
+
+                WatchedPath watched = found->second;
+                std::string path = watched.path + "/" + event->name;
+                std::string relative = path.substr(std::min(path.size(), watched.root.size() + 1));
+                if (IsExcludedBelow(rules, watched.root, relative, '/')) continue;
+
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    AddTree(watched.root, path);
+                    batch.Add(FolderChange::Added, std::move(path));
+                } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                    batch.Add(FolderChange::Removed, std::move(path));
+                }
+            }
+        }
+    }
+
+    void Run() {
+        EventBatch batch(settleMs, maxDelayMs);
+        while (true) {
+            pollfd fds[2] = { { stopPipe[0], POLLIN, 0 }, { inotifyFd, POLLIN, 0 } };
+            int ready = poll(fds, 2, batch.TimeoutMs());
+            if (ready < 0 || (fds[0].revents & POLLIN)) return;
+            if (fds[1].revents & POLLIN) Collect(batch);
+            batch.DeliverIfDue(callback);
+        }
+    }
+
+    ExcludeRules rules;
+    FolderEventCallback callback;
+    int inotifyFd = -1;
+    int stopPipe[2] = { -1, -1 };
+    std::unordered_map<int, WatchedPath> watchedPaths;
+    std::thread worker;
+};
+
+std::unique_ptr<DirectoryWatcher> CreateDirectoryWatcher() {
+    return std::make_unique<InotifyDirectoryWatcher>();
+}
+#endif
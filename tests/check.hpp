@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdio>
+
+// Each test is its own executable: CHECK reports a failed condition and
+// keeps going, and main returns CheckResult() so ctest sees the failure.
+inline int& CheckFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                                         \
+    do {                                                                                         \
+        if (!(condition)) {                                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);   \
+            ++CheckFailures();                                                                   \
+        }                                                                                        \
+    } while (0)
+
+inline int CheckResult() {
+    if (CheckFailures()) std::fprintf(stderr, "%d check(s) failed\n", CheckFailures());
+    return CheckFailures() ? 1 : 0;
+}
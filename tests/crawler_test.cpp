@@ -0,0 +1,218 @@
+// Crawls a generated tree with one worker and with many, and checks both
+// against a plain recursive walk: work stealing must not lose or repeat
+// folders, and the depth limit must cut the tree at the same place. A
+// small hand-made tree checks that descent stops at project roots.
+
+#include "check.hpp"
+#include "treegen.hpp"
+
+#include "crawler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+static std::vector<std::string> WalkTree(const std::string& root, int maxDepth) {
+    std::vector<std::string> folders;
+    std::error_code error;
+    for (auto it = std::filesystem::recursive_directory_iterator(root, error);
+         it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+        std::string name = it->path().filename().string();
+        if (name[0] == '.' || !it->is_directory()) {
+            it.disable_recursion_pending();
+            continue;
+        }
+        if (it.depth() + 1 > maxDepth) {
+            it.disable_recursion_pending();
+            continue;
+        }
+        folders.push_back(it->path().string());
+    }
+    std::sort(folders.begin(), folders.end());
+    return folders;
+}
+
+static std::vector<std::string> CrawlTree(CrawlerEngine& engine, const std::string& root, unsigned int workers, int maxDepth,
+                                          uint32_t timeBudgetMs = std::numeric_limits<uint32_t>::max()) {
+    CrawlOptions options;
+    options.maxDepth = maxDepth;
+    options.minDepth = maxDepth;
+    options.maxAdaptiveDepth = maxDepth;
+    options.workerCount = workers;
+    options.timeBudgetMs = timeBudgetMs;
+    options.entryBudget = std::numeric_limits<size_t>::max();
+    CrawlResult result = engine.Crawl({ root }, options);
+    CHECK(result.stats.size() == 1);
+    if (result.stats.size() == 1) {
+        CHECK(!result.stats[0].truncated);
+        CHECK(result.stats[0].timedOut == (timeBudgetMs == 0));
+        CHECK(result.stats[0].entries == result.folders.size());
+    }
+    std::sort(result.folders.begin(), result.folders.end());
+    return result.folders;
+}
+
+// With stopAtProjects a folder holding a marker is indexed as one entry
+// plus projectDepth levels of its subfolders, and excluded names stay out
+// at every level.
+static void TestProjects(const std::string& directory) {
+    std::string root = directory + "/projects";
+    std::error_code error;
+    for (const char* folder : { "plain/a/b/c", "git/.git/objects", "git/src/deep/deeper", "git/node_modules/pkg",
+                                "npm/lib/inner/innermost", "npm/src/node_modules/pkg" }) {
+        std::filesystem::create_directories(root + "/" + folder, error);
+        CHECK(!error);
+    }
+    std::ofstream(root + "/npm/package.json") << "{}";
+
+    ExcludeRules excludes;
+    excludes.Compile({ "node_modules" });
+    auto crawl = [&](bool stopAtProjects, int projectDepth) {
+        CrawlOptions options;
+        options.maxDepth = options.minDepth = options.maxAdaptiveDepth = 64;
+        options.timeBudgetMs = std::numeric_limits<uint32_t>::max();
+        options.entryBudget = std::numeric_limits<size_t>::max();
+        options.stopAtProjects = stopAtProjects;
+        options.projectDepth = projectDepth;
+        options.excludes = &excludes;
+        CrawlerEngine engine(NativeFileSystem());
+        CrawlResult result = engine.Crawl({ root }, options);
+        std::vector<std::string> folders;
+        for (const auto& path : result.folders) folders.push_back(path.substr(root.size() + 1));
+        std::sort(folders.begin(), folders.end());
+        return folders;
+    };
+    using Folders = std::vector<std::string>;
+
+    CHECK((crawl(true, 0) == Folders { "git", "npm", "plain", "plain/a", "plain/a/b", "plain/a/b/c" }));
+    CHECK((crawl(true, 1) == Folders { "git", "git/src", "npm", "npm/lib", "npm/src", "plain", "plain/a", "plain/a/b",
+                                       "plain/a/b/c" }));
+    CHECK((crawl(true, 2) == Folders { "git", "git/src", "git/src/deep", "npm", "npm/lib", "npm/lib/inner", "npm/src",
+                                       "plain", "plain/a", "plain/a/b", "plain/a/b/c" }));
+    CHECK((crawl(false, 0) == Folders { "git", "git/src", "git/src/deep", "git/src/deep/deeper", "npm", "npm/lib",
+                                        "npm/lib/inner", "npm/lib/inner/innermost", "npm/src", "plain", "plain/a",
+                                        "plain/a/b", "plain/a/b/c" }));
+    std::filesystem::remove_all(root, error);
+}
+
+int main() {
+    char directory[] = "/tmp/kinesis-crawl-XXXXXX";
+    CHECK(mkdtemp(directory) != nullptr);
+    std::string root = std::string(directory) + "/root";
+
+    TreeShape shape;
+    shape.directories = 20000;
+    shape.maxDepth = 10;
+    shape.hiddenRatio = 0.05;
+    shape.projectRatio = 0.02;
+    TreeStats stats;
+    CHECK(GenerateTree(root, shape, stats));
+    CHECK(stats.hidden > 0);
+
+    // Depth 0 lists the root's children, so a crawl at maxDepth reaches
+    // folders maxDepth + 1 levels down.
+    for (int maxDepth : { 64, 3 }) {
+        std::vector<std::string> expected = WalkTree(root, maxDepth + 1);
+        CHECK(!expected.empty());
+
+        CrawlerEngine serial(NativeFileSystem());
+        std::vector<std::string> serialFolders = CrawlTree(serial, root, 1, maxDepth);
+        CHECK(serialFolders == expected);
+
+        CrawlerEngine parallel(NativeFileSystem());
+        std::vector<std::string> parallelFolders = CrawlTree(parallel, root, 8, maxDepth);
+        CHECK(parallelFolders == expected);
+
+        // The second crawl answers unchanged folders from the cache.
+        CHECK(CrawlTree(parallel, root, 8, maxDepth) == expected);
+        std::printf("max depth %d: %zu folders\n", maxDepth, expected.size());
+    }
+
+    // Each root is reported on its own with exactly the folders of its
+    // subtree, before Crawl returns.
+    {
+        std::vector<std::string> roots;
+        for (const auto& entry : std::filesystem::directory_iterator(root)) {
+            if (entry.is_directory() && entry.path().filename().string()[0] != '.') roots.push_back(entry.path().string());
+            if (roots.size() == 3) break;
+        }
+        CHECK(roots.size() == 3);
+        std::vector<std::pair<std::string, std::vector<std::string>>> reported;
+        CrawlOptions options;
+        options.maxDepth = options.minDepth = options.maxAdaptiveDepth = 64;
+        options.timeBudgetMs = std::numeric_limits<uint32_t>::max();
+        options.entryBudget = std::numeric_limits<size_t>::max();
+        options.onRootDone = [&](const CrawlRootStats& stats, const std::vector<std::string>& folders) {
+            CHECK(stats.entries == folders.size());
+            reported.emplace_back(stats.root, folders);
+        };
+        CrawlerEngine engine(NativeFileSystem());
+        CrawlResult result = engine.Crawl(roots, options);
+        CHECK(reported.size() == roots.size());
+        size_t total = 0;
+        for (auto& entry : reported) {
+            std::sort(entry.second.begin(), entry.second.end());
+            CHECK(entry.second == WalkTree(entry.first, 65));
+            CHECK(std::find(roots.begin(), roots.end(), entry.first) != roots.end());
+            total += entry.second.size();
+        }
+        CHECK(result.folders.size() == total);
+    }
+
+    // A folder reached without listing its parent passes the same filter
+    // as a listed one.
+    {
+        std::vector<std::string> listed = WalkTree(root, 1);
+        CHECK(!listed.empty() && NativeFileSystem().IsListedFolder(listed[0]));
+        std::error_code error;
+        std::filesystem::create_directories(root + "/.hidden-added", error);
+        CHECK(!NativeFileSystem().IsListedFolder(root + "/.hidden-added"));
+        CHECK(!NativeFileSystem().IsListedFolder(root + "/missing"));
+        std::filesystem::remove(root + "/.hidden-added", error);
+    }
+
+    // A cancelled crawl stops early and leaves the cached records alone, so
+    // the next crawl is still complete.
+    {
+        CrawlerEngine engine(NativeFileSystem());
+        std::vector<std::string> expected = CrawlTree(engine, root, 4, 64);
+        CrawlOptions options;
+        options.maxDepth = options.minDepth = options.maxAdaptiveDepth = 64;
+        options.workerCount = 4;
+        options.timeBudgetMs = std::numeric_limits<uint32_t>::max();
+        options.entryBudget = std::numeric_limits<size_t>::max();
+        std::atomic<size_t> polls(0);
+        options.isCancelled = [&polls] { return ++polls > 100; };
+        CrawlResult cancelled = engine.Crawl({ root }, options);
+        CHECK(cancelled.cancelled);
+        CHECK(cancelled.folders.size() < expected.size());
+        CHECK(CrawlTree(engine, root, 4, 64) == expected);
+    }
+
+    // Renamed, added and removed folders show up in a warm crawl, and a
+    // crawl out of time answers from the cached tree.
+    CrawlerEngine engine(NativeFileSystem());
+    std::vector<std::string> before = CrawlTree(engine, root, 4, 64);
+    std::string moved = before[before.size() / 2];
+    std::error_code error;
+    std::filesystem::rename(moved, moved + "-renamed", error);
+    CHECK(!error);
+    std::filesystem::create_directories(root + "/added/nested/deeper", error);
+    std::filesystem::remove_all(before[1], error);
+    std::vector<std::string> expected = WalkTree(root, 65);
+    CHECK(expected != before);
+    CHECK(CrawlTree(engine, root, 4, 64) == expected);
+    CHECK(CrawlTree(engine, root, 4, 64, 0) == expected);
+    CHECK(CrawlTree(engine, root, 4, 64) == expected);
+    std::printf("directory cache: %zu bytes for %zu folders\n", engine.CacheByteSize(), expected.size());
+
+    TestProjects(directory);
+    RemoveTree(directory);
+    return CheckResult();
+}
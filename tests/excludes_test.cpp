@@ -0,0 +1,114 @@
+// Exclude rules as the crawler and the watcher apply them: folder names,
+// name globs, '**' segments, the three anchors, case and either separator.
+// A pathological pattern must fail quickly rather than backtrack forever.
+
+#include "check.hpp"
+
+#include "excludes.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+static ExcludeRules Compile(const std::vector<std::string>& patterns) {
+    ExcludeRules rules;
+    rules.Compile(patterns);
+    return rules;
+}
+
+// Tests the last segment of path as the crawler does, with name split off.
+static bool Excludes(const ExcludeRules& rules, const std::string& path, const std::string& root) {
+    size_t separator = path.find_last_of("\\/");
+    std::string name = separator == std::string::npos ? path : path.substr(separator + 1);
+    return rules.Matches(name, path, root);
+}
+
+static void TestNames() {
+    ExcludeRules rules = Compile({ "node_modules", "Target", "build-*", "?bj", "**/.venv", "", "/" });
+    const std::string root = "C:\\src";
+    CHECK(!rules.Empty());
+    CHECK(Excludes(rules, "C:\\src\\app\\node_modules", root));
+    CHECK(Excludes(rules, "C:\\src\\TARGET", root));
+    CHECK(Excludes(rules, "C:\\src\\target", root));
+    CHECK(Excludes(rules, "C:\\src\\Build-Release", root));
+    CHECK(Excludes(rules, "C:\\src\\obj", root));
+    CHECK(Excludes(rules, "C:\\src\\a\\b\\.venv", root));
+    CHECK(!Excludes(rules, "C:\\src\\node_modules2", root));
+    CHECK(!Excludes(rules, "C:\\src\\build", root));
+    CHECK(!Excludes(rules, "C:\\src\\objects", root));
+    CHECK(!Excludes(rules, "C:\\src\\targets", root));
+    CHECK(Compile({}).Empty());
+    CHECK(Compile({ "", "/", "\\" }).Empty());
+}
+
+static void TestPathGlobs() {
+    // Floating patterns match the end of the path at any depth.
+    ExcludeRules floating = Compile({ "build/out", "docs/**/generated" });
+    const std::string root = "C:\\src";
+    CHECK(Excludes(floating, "C:\\src\\build\\out", root));
+    CHECK(Excludes(floating, "C:\\src\\app\\Build\\OUT", root));
+    CHECK(!Excludes(floating, "C:\\src\\build\\out\\more", root));
+    CHECK(!Excludes(floating, "C:\\src\\mybuild\\out", root));
+    CHECK(Excludes(floating, "C:\\src\\docs\\generated", root));
+    CHECK(Excludes(floating, "C:\\src\\docs\\a\\b\\generated", root));
+    CHECK(!Excludes(floating, "C:\\src\\docs\\a\\generated2", root));
+
+    // '*' stays within a segment, '**' spans them.
+    ExcludeRules star = Compile({ "vendor/*/cache" });
+    CHECK(Excludes(star, "C:\\src\\vendor\\pkg\\cache", root));
+    CHECK(!Excludes(star, "C:\\src\\vendor\\a\\b\\cache", root));
+
+    // A trailing '**' covers what is inside the folder but not the folder.
+    ExcludeRules inside = Compile({ "/out/**" });
+    CHECK(!Excludes(inside, "C:\\src\\out", root));
+    CHECK(Excludes(inside, "C:\\src\\out\\x", root));
+    CHECK(Excludes(inside, "C:\\src\\out\\x\\y", root));
+}
+
+static void TestAnchors() {
+    // A leading '/' anchors to the crawl root, whichever separator the root
+    // and the path use.
+    ExcludeRules rooted = Compile({ "/mnt/c/**", "/Projects" });
+    const std::string wsl = "\\\\wsl.localhost\\Ubuntu";
+    CHECK(Excludes(rooted, wsl + "\\mnt\\c\\Users", wsl));
+    CHECK(Excludes(rooted, "//wsl.localhost/Ubuntu/mnt/c/Users", "//wsl.localhost/Ubuntu"));
+    CHECK(!Excludes(rooted, wsl + "\\mnt\\c", wsl));
+    CHECK(!Excludes(rooted, wsl + "\\mnt\\d\\x", wsl));
+    CHECK(!Excludes(rooted, wsl + "\\home\\mnt\\c\\x", wsl));
+    CHECK(Excludes(rooted, "C:\\Users\\me\\projects", "C:\\Users\\me"));
+    CHECK(Excludes(rooted, "C:\\Users\\me\\projects", "C:\\Users\\me\\"));
+    CHECK(!Excludes(rooted, "C:\\Users\\me\\a\\projects", "C:\\Users\\me"));
+    // A root that is only a string prefix of the path does not anchor it.
+    CHECK(!Excludes(rooted, "C:\\Users\\meta\\projects", "C:\\Users\\me"));
+
+    // A drive letter or a UNC share anchors to the start of the full path.
+    ExcludeRules absolute = Compile({ "C:/Users/*/AppData", "\\\\wsl.localhost\\Ubuntu\\proc" });
+    CHECK(Excludes(absolute, "C:\\Users\\me\\AppData", "C:\\Users"));
+    CHECK(Excludes(absolute, "c:/users/ME/appdata", "D:\\"));
+    CHECK(!Excludes(absolute, "D:\\Users\\me\\AppData", "D:\\"));
+    CHECK(!Excludes(absolute, "C:\\Users\\me\\AppData\\Local", "C:\\Users"));
+    CHECK(Excludes(absolute, "\\\\wsl.localhost\\Ubuntu\\proc", "\\\\wsl.localhost\\Ubuntu"));
+    CHECK(!Excludes(absolute, "\\\\wsl.localhost\\Ubuntu\\home\\proc", "\\\\wsl.localhost\\Ubuntu"));
+}
+
+static void TestPathological() {
+    ExcludeRules rules = Compile({ "*a*a*a*a*a*a*a*a*a*a*b", "**/a/**/a/**/a/**/a/**/a/**/a/**/b" });
+    std::string name(200, 'a');
+    std::string deep = "C:";
+    for (int i = 0; i < 60; ++i) deep += "\\a";
+
+    auto start = std::chrono::steady_clock::now();
+    CHECK(!Excludes(rules, "C:\\" + name, "C:\\"));
+    CHECK(!Excludes(rules, deep, "C:\\"));
+    CHECK(Excludes(rules, deep + "\\b", "C:\\"));
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    CHECK(elapsedMs < 100.0);
+}
+
+int main() {
+    TestNames();
+    TestPathGlobs();
+    TestAnchors();
+    TestPathological();
+    return CheckResult();
+}
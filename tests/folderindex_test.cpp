@@ -0,0 +1,189 @@
+// Round-trips a synthetic million-path index through Save and Load and
+// reports how long opening the snapshot takes, since that is what the
+// launcher pays at startup before the first query can run.
+
+#include "check.hpp"
+#include "synthetic.hpp"
+
+#include "folderindex.hpp"
+#include "matcher.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+static const size_t pathCount = 1000000;
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void CheckSameIndex(const FolderIndex& index, const std::vector<std::string>& sorted) {
+    CHECK(index.Size() == sorted.size());
+    if (index.Size() != sorted.size()) return;
+
+    FolderIndex::Decoder decoder(index);
+    size_t mismatches = 0;
+    uint64_t blockMask = 0;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        decoder.Seek(i);
+        if (decoder.Path() != sorted[i]) ++mismatches;
+        blockMask |= CharMask(LowerPattern(sorted[i]));
+        if ((i + 1) % FolderIndex::blockSize == 0 || i + 1 == sorted.size()) {
+            if (index.BlockCharMask(i / FolderIndex::blockSize) != blockMask) ++mismatches;
+            blockMask = 0;
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+static void CheckTrigrams(const FolderIndex& index, const std::vector<std::string>& sorted, std::string_view pattern) {
+    std::vector<uint32_t> candidates;
+    CHECK(index.TrigramCandidates(pattern, candidates));
+    CHECK(std::is_sorted(candidates.begin(), candidates.end()));
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        if (LowerPattern(sorted[i]).find(pattern) == std::string::npos) continue;
+        if (!std::binary_search(candidates.begin(), candidates.end(), (uint32_t)i)) {
+            CHECK(!"trigram candidates miss a matching path");
+            return;
+        }
+    }
+}
+
+static void CheckRejected(const std::string& filePath) {
+    FolderIndex index;
+    CHECK(!index.Load(filePath));
+    CHECK(index.Empty());
+}
+
+// Saving while the previous generation is still mapped must leave the
+// mapping readable, drop the old file and make the new one the newest.
+static void TestGenerations(const std::string& directory) {
+    std::vector<std::string> first = SyntheticPaths(2000, 1);
+    std::vector<std::string> second = SyntheticPaths(3000, 2);
+    std::sort(first.begin(), first.end());
+    std::sort(second.begin(), second.end());
+
+    SnapshotFiles files(directory, "gen");
+    FolderIndex index;
+    CHECK(!files.LoadNewest(index));
+    index.Build(first);
+    CHECK(files.Save(index));
+    std::ofstream(files.PathFor(1) + ".tmp") << "left over";
+
+    FolderIndex mapped;
+    CHECK(SnapshotFiles(directory, "gen").LoadNewest(mapped));
+    CheckSameIndex(mapped, first);
+
+    index.Build(second);
+    CHECK(files.Save(index));
+    CHECK(access(files.PathFor(1).c_str(), F_OK) != 0);
+    CHECK(access((files.PathFor(1) + ".tmp").c_str(), F_OK) != 0);
+    CheckSameIndex(mapped, first);
+
+    FolderIndex newest;
+    SnapshotFiles reopened(directory, "gen");
+    CHECK(reopened.LoadNewest(newest));
+    CheckSameIndex(newest, second);
+    CHECK(reopened.Save(newest));
+    CHECK(access(files.PathFor(3).c_str(), F_OK) == 0);
+    CHECK(access(files.PathFor(2).c_str(), F_OK) != 0);
+    std::remove(files.PathFor(3).c_str());
+}
+
+// Replacing ranges of an index must give the same index as building the
+// resulting set of paths from scratch.
+static void TestReplaced() {
+    std::vector<std::string> paths = SyntheticPaths(5000, 3);
+    std::sort(paths.begin(), paths.end());
+    FolderIndex base;
+    base.Build(paths);
+
+    IdRange desktop = base.PrefixRange("C:\\Users\\me\\Desktop\\");
+    CHECK(desktop.end > desktop.begin);
+    std::vector<IdRange> removed { { 10, 11 }, desktop, { 0, 3 }, { 2, 5 } };
+    std::vector<std::string> added { "C:\\Users\\me\\Desktop\\new", paths[100], "\\\\wsl.localhost\\a",
+                                     "C:\\Users\\me\\Desktop\\new", "zzz", "A" };
+
+    std::vector<std::string> expected;
+    for (size_t id = 0; id < paths.size(); ++id) {
+        bool isRemoved = false;
+        for (const auto& range : removed) isRemoved = isRemoved || (id >= range.begin && id < range.end);
+        if (!isRemoved) expected.push_back(paths[id]);
+    }
+    expected.insert(expected.end(), added.begin(), added.end());
+    std::sort(expected.begin(), expected.end());
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+    FolderIndex replaced;
+    replaced.BuildReplaced(base, removed, added);
+    CheckSameIndex(replaced, expected);
+    CheckTrigrams(replaced, expected, "desktop\\new");
+
+    FolderIndex unchanged;
+    unchanged.BuildReplaced(base, {}, {});
+    CheckSameIndex(unchanged, paths);
+}
+
+int main() {
+    std::vector<std::string> paths = SyntheticPaths(pathCount);
+    std::vector<std::string> sorted = paths;
+    std::sort(sorted.begin(), sorted.end());
+
+    auto buildStart = std::chrono::steady_clock::now();
+    FolderIndex built;
+    built.Build(paths);
+    double buildMs = MillisecondsSince(buildStart);
+    CheckSameIndex(built, sorted);
+
+    char directory[] = "/tmp/kinesis-index-XXXXXX";
+    CHECK(mkdtemp(directory) != nullptr);
+    std::string filePath = std::string(directory) + "/folders.idx";
+
+    auto saveStart = std::chrono::steady_clock::now();
+    CHECK(built.Save(filePath));
+    double saveMs = MillisecondsSince(saveStart);
+    CHECK(access((filePath + ".tmp").c_str(), F_OK) != 0);
+
+    auto openStart = std::chrono::steady_clock::now();
+    FolderIndex loaded;
+    CHECK(loaded.Load(filePath));
+    double openMs = MillisecondsSince(openStart);
+
+    CHECK(loaded.ByteSize() == built.ByteSize());
+    CheckSameIndex(loaded, sorted);
+    CheckTrigrams(loaded, sorted, "widget");
+    CheckTrigrams(loaded, sorted, "photos2023\\kin");
+
+    IdRange range = loaded.PrefixRange("\\\\wsl.localhost\\");
+    size_t expected = 0;
+    for (const auto& path : sorted) expected += path.compare(0, 16, "\\\\wsl.localhost\\") == 0;
+    CHECK(range.end - range.begin == expected);
+
+    // A snapshot of a different version or a cut-off file must not load.
+    std::string truncatedPath = std::string(directory) + "/truncated.idx";
+    {
+        std::ifstream in(filePath, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream(truncatedPath, std::ios::binary).write(bytes.data(), bytes.size() / 2);
+        bytes[4] ^= 0x7F;
+        std::ofstream(filePath, std::ios::binary | std::ios::trunc).write(bytes.data(), bytes.size());
+    }
+    CheckRejected(truncatedPath);
+    CheckRejected(filePath);
+    CheckRejected(std::string(directory) + "/missing.idx");
+
+    std::printf("%zu paths, %zu bytes: build %.0f ms, save %.0f ms, open %.3f ms\n", sorted.size(),
+                loaded.ByteSize(), buildMs, saveMs, openMs);
+
+    std::remove(filePath.c_str());
+    std::remove(truncatedPath.c_str());
+    TestGenerations(directory);
+    TestReplaced();
+    rmdir(directory);
+    return CheckResult();
+}
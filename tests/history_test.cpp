@@ -0,0 +1,203 @@
+// Launch history as the launcher keeps it: launches go to the journal,
+// a restart replays the journal over the saved history, and compaction
+// folds the journal back into the history file. A crash at any step of a
+// compaction must leave files that replay to the same history. Scores
+// decay with a 14-day half-life, and an old most-recently-used list loads
+// in its original order.
+
+#include "check.hpp"
+#include "treegen.hpp"
+
+#include "history.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+static std::string ReadFile(const std::string& path) {
+    std::ifstream file(path);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static bool SameHistory(const FrecencyStore& a, const FrecencyStore& b) {
+    if (a.Sequence() != b.Sequence() || a.Entries().size() != b.Entries().size()) return false;
+    for (size_t i = 0; i < a.Entries().size(); ++i) {
+        const HistoryEntry& left = a.Entries()[i];
+        const HistoryEntry& right = b.Entries()[i];
+        if (left.path != right.path || left.launchCount != right.launchCount || left.lastLaunch != right.lastLaunch) return false;
+        if (left.frecency != right.frecency) return false;
+    }
+    return true;
+}
+
+static const HistoryEntry* Find(const FrecencyStore& store, const std::string& path) {
+    for (const auto& entry : store.Entries()) {
+        if (entry.path == path) return &entry;
+    }
+    return nullptr;
+}
+
+// Records launches the way AddToHistory does: in the store and, through
+// the journal's worker, in the journal file.
+static void Launch(FrecencyStore& store, HistoryJournal& journal, const std::string& journalPath, const std::string& path,
+                   int64_t time) {
+    uint64_t sequence = store.Record(path, time);
+    journal.Append(journalPath, sequence, path, time);
+}
+
+static void TestReplay(const std::string& directory) {
+    std::string historyPath = directory + "/replay.txt";
+    std::string journalPath = directory + "/replay.journal";
+    const int64_t now = 1700000000;
+
+    FrecencyStore live;
+    CHECK(live.Save(historyPath));
+    HistoryJournal journal;
+    journal.Start();
+    Launch(live, journal, journalPath, "C:\\a", now);
+    Launch(live, journal, journalPath, "C:\\a", now);
+    Launch(live, journal, journalPath, "C:\\b", now);
+    Launch(live, journal, journalPath, "C:\\a", now + 1);
+    journal.Stop();
+    CHECK(live.Sequence() == 4);
+
+    // Two launches in the same second are two launches.
+    FrecencyStore restored;
+    CHECK(restored.Load(historyPath, now));
+    CHECK(restored.Replay(journalPath) == 4);
+    CHECK(SameHistory(restored, live));
+    const HistoryEntry* a = Find(restored, "C:\\a");
+    CHECK(a && a->launchCount == 3 && a->lastLaunch == now + 1);
+
+    // Replaying the same journal again adds nothing.
+    CHECK(restored.Replay(journalPath) == 0);
+    CHECK(SameHistory(restored, live));
+
+    // A journal written before sequence numbers still replays by time.
+    std::ofstream(journalPath, std::ios::app) << (now + 5) << "\tC:\\c\n" << now << "\tC:\\a\n";
+    CHECK(restored.Replay(journalPath) == 1);
+    CHECK(Find(restored, "C:\\c") && Find(restored, "C:\\a")->launchCount == 3);
+}
+
+static void TestCompaction(const std::string& directory) {
+    std::string historyPath = directory + "/compact.txt";
+    std::string journalPath = directory + "/compact.journal";
+    const int64_t now = 1700000000;
+
+    FrecencyStore live;
+    HistoryJournal journal;
+    journal.Start();
+    for (int i = 0; i < 10; ++i) Launch(live, journal, journalPath, "C:\\p" + std::to_string(i % 3), now + i / 4);
+    journal.Compact(historyPath, journalPath, live);
+    Launch(live, journal, journalPath, "C:\\p0", now + 9);
+    journal.Stop();
+
+    // The compaction emptied the journal; only the later launch is left.
+    CHECK(ReadFile(journalPath) == "11\t" + std::to_string(now + 9) + "\tC:\\p0\n");
+    CHECK(access((historyPath + ".tmp").c_str(), F_OK) != 0);
+    FrecencyStore restored;
+    CHECK(restored.Load(historyPath, now));
+    CHECK(restored.Sequence() == 10);
+    CHECK(restored.Replay(journalPath) == 1);
+    CHECK(SameHistory(restored, live));
+}
+
+static void TestCrashDuringCompaction(const std::string& directory) {
+    std::string historyPath = directory + "/crash.txt";
+    std::string journalPath = directory + "/crash.journal";
+    const int64_t now = 1700000000;
+
+    FrecencyStore live;
+    HistoryJournal journal;
+    journal.Start();
+    Launch(live, journal, journalPath, "C:\\x", now);
+    journal.Compact(historyPath, journalPath, live);
+    for (int i = 0; i < 5; ++i) Launch(live, journal, journalPath, i % 2 ? "C:\\x" : "C:\\y", now + 1);
+    journal.Stop();
+    std::string fullJournal = ReadFile(journalPath);
+    FrecencyStore oldHistory;
+    CHECK(oldHistory.Load(historyPath, now));
+
+    // Crash before the replace: the saved copy was left as .tmp and the
+    // old history still stands next to the whole journal.
+    CHECK(live.Save(historyPath + ".tmp"));
+    FrecencyStore beforeReplace;
+    CHECK(beforeReplace.Load(historyPath, now));
+    CHECK(beforeReplace.Replay(journalPath) == 5);
+    CHECK(SameHistory(beforeReplace, live));
+    std::remove((historyPath + ".tmp").c_str());
+
+    // Crash after the replace but before the journal was emptied: every
+    // journal record is already in the new history.
+    CHECK(live.Save(historyPath));
+    CHECK(ReadFile(journalPath) == fullJournal);
+    FrecencyStore beforeTruncate;
+    CHECK(beforeTruncate.Load(historyPath, now));
+    CHECK(beforeTruncate.Replay(journalPath) == 0);
+    CHECK(SameHistory(beforeTruncate, live));
+    CHECK(Find(beforeTruncate, "C:\\y")->launchCount == 3);
+    CHECK(oldHistory.Sequence() == 1);
+}
+
+static void TestFrecency(const std::string& directory) {
+    const int64_t now = 1700000000;
+    const int64_t halfLife = 14 * 24 * 3600;
+
+    // A score halves every 14 days, and a launch adds one to what is left.
+    FrecencyStore store;
+    store.Record("C:\\old", now - 2 * halfLife);
+    store.Record("C:\\old", now - halfLife);
+    const HistoryEntry* old = Find(store, "C:\\old");
+    CHECK(old && std::fabs(old->frecency - 1.5) < 1e-12);
+    CHECK(std::fabs(store.Score(*old, now) - 0.75) < 1e-12);
+    CHECK(store.Score(*old, now - 2 * halfLife) == old->frecency);
+
+    // The snapshot ranks by decayed score and adds 16 * log2(1 + score).
+    for (int i = 0; i < 3; ++i) store.Record("C:\\busy", now);
+    store.Record("C:\\twice", now - 3600);
+    store.Record("C:\\twice", now);
+    auto snapshot = BuildHistorySnapshot(store, now);
+    CHECK((snapshot->paths == std::vector<std::string> { "C:\\busy", "C:\\twice", "C:\\old" }));
+    CHECK((snapshot->rankBonus == std::vector<int> { 32, 25, 13 }));
+    CHECK(snapshot->lowerPaths[0] == "c:\\busy" && snapshot->basenames[0] == 3);
+    CHECK(snapshot->Contains("C:\\old") && !snapshot->Contains("C:\\once"));
+
+    // Scores survive a save bit for bit, including decayed ones that six
+    // digits would round.
+    std::string historyPath = directory + "/frecency.txt";
+    CHECK(store.Save(historyPath));
+    FrecencyStore loaded;
+    CHECK(loaded.Load(historyPath, now));
+    CHECK(SameHistory(loaded, store));
+
+    // A legacy history is a plain path list, most recent first. Each path
+    // becomes one launch an hour older than the one before it, so the old
+    // order holds; a repeated path keeps its first place.
+    std::string legacyPath = directory + "/legacy.txt";
+    std::ofstream(legacyPath) << "C:\\first\nC:\\second\n\nC:\\first\nC:\\third\n";
+    FrecencyStore legacy;
+    CHECK(legacy.Load(legacyPath, now));
+    CHECK(legacy.Entries().size() == 3 && legacy.Sequence() == 0);
+    const HistoryEntry* third = Find(legacy, "C:\\third");
+    CHECK(third && third->launchCount == 1 && third->frecency == 1.0 && third->lastLaunch == now - 2 * 3600);
+    auto migrated = BuildHistorySnapshot(legacy, now);
+    CHECK((migrated->paths == std::vector<std::string> { "C:\\first", "C:\\second", "C:\\third" }));
+    CHECK(migrated->rankBonus[0] == 16);
+}
+
+int main() {
+    char directory[] = "/tmp/kinesis-history-XXXXXX";
+    CHECK(mkdtemp(directory) != nullptr);
+
+    TestReplay(directory);
+    TestCompaction(directory);
+    TestCrashDuringCompaction(directory);
+    TestFrecency(directory);
+
+    RemoveTree(directory);
+    return CheckResult();
+}
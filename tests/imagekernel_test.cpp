@@ -0,0 +1,92 @@
+// ScaleAndFade: output is premultiplied and faded, area filtering averages
+// exactly, and transparent pixels never tint their neighbours.
+
+#include "check.hpp"
+
+#include "imagekernel.hpp"
+
+#include <cstdlib>
+
+static uint32_t Argb(uint32_t a, uint32_t r, uint32_t g, uint32_t b) {
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+static uint32_t Channel(uint32_t pixel, int shift) {
+    return (pixel >> shift) & 0xFF;
+}
+
+static bool Near(uint32_t a, uint32_t b) {
+    return std::abs((int)a - (int)b) <= 1;
+}
+
+static PixelBuffer Filled(int width, int height, uint32_t pixel) {
+    PixelBuffer buffer;
+    buffer.width = width;
+    buffer.height = height;
+    buffer.pixels.assign((size_t)width * height, pixel);
+    return buffer;
+}
+
+static void TestUniform() {
+    PixelBuffer target;
+    ScaleAndFade(Filled(37, 23, Argb(255, 200, 100, 50)), 11, 7, 0.5f, target);
+    CHECK(target.width == 11 && target.height == 7 && target.pixels.size() == 77);
+    for (uint32_t pixel : target.pixels) {
+        CHECK(Near(Channel(pixel, 24), 128) && Near(Channel(pixel, 16), 100));
+        CHECK(Near(Channel(pixel, 8), 50) && Near(Channel(pixel, 0), 25));
+    }
+
+    // Half-transparent source: colours come out multiplied by alpha.
+    ScaleAndFade(Filled(4, 4, Argb(128, 255, 0, 0)), 4, 4, 1.0f, target);
+    for (uint32_t pixel : target.pixels) CHECK(Near(Channel(pixel, 24), 128) && Near(Channel(pixel, 16), 128));
+}
+
+static void TestAreaAverage() {
+    PixelBuffer source = Filled(2, 2, 0);
+    source.pixels = { Argb(255, 0, 0, 0), Argb(255, 255, 0, 0), Argb(255, 0, 255, 0), Argb(255, 0, 0, 255) };
+    PixelBuffer target;
+    ScaleAndFade(source, 1, 1, 1.0f, target);
+    CHECK(target.pixels.size() == 1);
+    if (target.pixels.size() == 1) {
+        CHECK(Channel(target.pixels[0], 24) == 255);
+        CHECK(Near(Channel(target.pixels[0], 16), 64) && Near(Channel(target.pixels[0], 8), 64));
+        CHECK(Near(Channel(target.pixels[0], 0), 64));
+    }
+}
+
+static void TestNoBleed() {
+    // Left half opaque blue, right half fully transparent but red.
+    PixelBuffer source = Filled(64, 64, 0);
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 64; ++x) source.pixels[y * 64 + x] = x < 32 ? Argb(255, 0, 0, 255) : Argb(0, 255, 0, 0);
+    }
+    for (int size : { 10, 25, 100 }) {
+        PixelBuffer target;
+        ScaleAndFade(source, size, size, 0.12f, target);
+        for (uint32_t pixel : target.pixels) {
+            uint32_t alpha = Channel(pixel, 24);
+            CHECK(Channel(pixel, 16) == 0 && Channel(pixel, 8) == 0);
+            CHECK(Channel(pixel, 0) <= alpha);
+        }
+        CHECK(Near(Channel(target.pixels[0], 24), 31));
+        CHECK(target.pixels[size - 1] == 0);
+    }
+}
+
+static void TestEmpty() {
+    PixelBuffer target;
+    ScaleAndFade(PixelBuffer(), 3, 2, 1.0f, target);
+    CHECK(target.pixels.size() == 6);
+    for (uint32_t pixel : target.pixels) CHECK(pixel == 0);
+
+    ScaleAndFade(Filled(4, 4, Argb(255, 1, 2, 3)), 0, 5, 1.0f, target);
+    CHECK(target.Empty() && target.width == 0);
+}
+
+int main() {
+    TestUniform();
+    TestAreaAverage();
+    TestNoBleed();
+    TestEmpty();
+    return CheckResult();
+}
@@ -0,0 +1,192 @@
+// Scoring rules of the fuzzy and exact matchers, MatchIndex against a
+// brute-force scan of every path with the same scorer, and the candidate
+// cache that narrows each keystroke from the survivors of the last.
+
+#include "check.hpp"
+#include "synthetic.hpp"
+
+#include "folderindex.hpp"
+#include "matchengine.hpp"
+#include "matcher.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+static size_t BasenameOffset(std::string_view path) {
+    size_t separator = path.find_last_of("\\/");
+    return separator == std::string_view::npos ? 0 : separator + 1;
+}
+
+static bool Fuzzy(std::string_view pattern, std::string_view path, int& score) {
+    std::string lowerPath = LowerPattern(path);
+    return FuzzyMatch(LowerPattern(pattern), path, lowerPath, BasenameOffset(path), score);
+}
+
+static bool Exact(std::string_view pattern, std::string_view path, int& score) {
+    std::string lowerPath = LowerPattern(path);
+    return ExactMatch(LowerPattern(pattern), path, lowerPath, BasenameOffset(path), score);
+}
+
+// True when pattern matches both paths and scores better on the first.
+static bool Prefers(std::string_view pattern, std::string_view better, std::string_view worse) {
+    int betterScore = 0;
+    int worseScore = 0;
+    return Fuzzy(pattern, better, betterScore) && Fuzzy(pattern, worse, worseScore) && betterScore > worseScore;
+}
+
+static void TestScoring() {
+    int score = 0;
+    CHECK(Fuzzy("kns", "C:\\Work\\Kinesis", score));
+    CHECK(Fuzzy("", "C:\\Work", score) && score == 0);
+    CHECK(!Fuzzy("snk", "C:\\Work\\Kinesis", score));
+    CHECK(!Fuzzy("kinesisx", "C:\\Work\\Kinesis", score));
+
+    CHECK(Exact("nesi", "C:\\Work\\Kinesis", score));
+    CHECK(!Exact("kns", "C:\\Work\\Kinesis", score));
+
+    CHECK(Prefers("core", "C:\\src\\core", "C:\\src\\cxoxrxe"));
+    CHECK(Prefers("src", "C:\\docs\\src", "C:\\src\\docs"));
+    CHECK(Prefers("wb", "C:\\code\\WidgetBar", "C:\\code\\widgetbar"));
+    CHECK(Prefers("api", "C:\\code\\web-api", "C:\\code\\rapid"));
+    CHECK(Prefers("ck", "C:\\Code\\kinesis", "C:\\Code\\deskinesis"));
+}
+
+static void TestTopMatches() {
+    std::mt19937 rng(7);
+    std::vector<ScoredMatch> all;
+    TopMatches left(10);
+    TopMatches right(10);
+    for (uint32_t id = 0; id < 1000; ++id) {
+        ScoredMatch match { (int)(rng() % 50), id, 10 + (uint32_t)(rng() % 20) };
+        all.push_back(match);
+        (id % 2 ? left : right).Offer(match.score, match.id, match.length);
+    }
+    left.Merge(right);
+    std::vector<ScoredMatch> best = left.Sorted();
+
+    std::sort(all.begin(), all.end(), [](const ScoredMatch& a, const ScoredMatch& b) {
+        if (a.score != b.score) return a.score > b.score;
+        if (a.length != b.length) return a.length < b.length;
+        return a.id < b.id;
+    });
+    CHECK(best.size() == 10);
+    for (size_t i = 0; i < best.size() && i < all.size(); ++i) CHECK(best[i].id == all[i].id);
+
+    TopMatches none(0);
+    none.Offer(1, 1, 1);
+    CHECK(none.Sorted().empty());
+}
+
+// MatchIndex must return exactly the brute-force top list and survivors,
+// whatever the thread count and whether or not a candidate list is given.
+// The counts go up and down, so pool threads left idle by a smaller call
+// must sit the call out.
+static void TestMatchIndex() {
+    FolderIndex index;
+    index.Build(SyntheticPaths(50000));
+    std::vector<IdRange> view { { 0, (uint32_t)index.Size() } };
+
+    for (bool exact : { false, true }) {
+        for (std::string pattern : { "kin", "srcwidget", "photos2023", "zzzz" }) {
+            std::vector<ScoredMatch> expected;
+            std::vector<uint32_t> expectedSurvivors;
+            TopMatches top(25);
+            for (uint32_t id = 0; id < index.Size(); ++id) {
+                std::string path = index.Path(id);
+                int score = 0;
+                if (!(exact ? Exact(pattern, path, score) : Fuzzy(pattern, path, score))) continue;
+                expectedSurvivors.push_back(id);
+                top.Offer(score, id, (uint32_t)path.size());
+            }
+            expected = top.Sorted();
+
+            for (unsigned int threads : { 1u, 4u, 2u, 8u }) {
+                for (bool withCandidates : { false, true }) {
+                    std::vector<uint32_t> everything(index.Size());
+                    for (uint32_t id = 0; id < index.Size(); ++id) everything[id] = id;
+
+                    IndexMatchOptions options;
+                    options.lowerPattern = pattern;
+                    options.exact = exact;
+                    options.limit = 25;
+                    options.threadCount = threads;
+                    IndexMatchResult result;
+                    MatchIndex(index, view, withCandidates ? &everything : nullptr, options, result);
+
+                    CHECK(result.survivors == expectedSurvivors);
+                    CHECK(result.best.size() == expected.size());
+                    for (size_t i = 0; i < result.best.size() && i < expected.size(); ++i) {
+                        CHECK(result.best[i].id == expected[i].id && result.best[i].score == expected[i].score);
+                    }
+                }
+            }
+        }
+    }
+}
+
+static std::vector<uint32_t> Survivors(const FolderIndex& index, const std::string& pattern,
+                                       const std::vector<uint32_t>* candidates) {
+    std::vector<IdRange> view { { 0, (uint32_t)index.Size() } };
+    IndexMatchOptions options;
+    options.lowerPattern = pattern;
+    options.limit = 25;
+    IndexMatchResult result;
+    MatchIndex(index, view, candidates, options, result);
+    return result.survivors;
+}
+
+// Each query runs the way the launcher runs it: narrow, match, store. A
+// cache that handed back the wrong level would silently drop matches, so
+// every narrowed scan must equal a full one.
+static void TestCandidateCache() {
+    std::vector<std::string> paths = SyntheticPaths(20000);
+    FolderIndex index;
+    index.Build(paths);
+    CandidateCache cache;
+    CHECK(cache.Narrow("s") == nullptr);
+
+    // Typing forward narrows from the previous keystroke's survivors.
+    std::vector<std::string> typed { "s", "sr", "src", "srcw" };
+    std::vector<std::vector<uint32_t>> full;
+    for (size_t i = 0; i < typed.size(); ++i) {
+        const std::vector<uint32_t>* candidates = cache.Narrow(typed[i]);
+        CHECK(i == 0 ? candidates == nullptr : candidates && *candidates == full[i - 1]);
+        full.push_back(Survivors(index, typed[i], nullptr));
+        CHECK(Survivors(index, typed[i], candidates) == full[i]);
+        cache.Store(typed[i], full[i]);
+    }
+    CHECK(full[0].size() > full[3].size() && !full[3].empty());
+
+    // Backspace returns to the stored level for the shorter input, and
+    // typing a different letter there narrows from the common prefix.
+    const std::vector<uint32_t>* back = cache.Narrow("src");
+    CHECK(back && *back == full[2]);
+    back = cache.Narrow("sr");
+    CHECK(back && *back == full[1]);
+    back = cache.Narrow("sx");
+    CHECK(back && *back == full[0]);
+    CHECK(cache.Narrow("k") == nullptr);
+
+    // A new index renumbers the paths, so survivors of the old one point
+    // at the wrong folders and the cache is cleared on the swap, as
+    // RunMatchRequest does.
+    cache.Store("src", full[2]);
+    paths.push_back("C:\\Archive\\src");
+    FolderIndex swapped;
+    swapped.Build(paths);
+    std::vector<uint32_t> expected = Survivors(swapped, "src", nullptr);
+    CHECK(Survivors(swapped, "src", cache.Narrow("src")) != expected);
+    cache.Clear();
+    CHECK(cache.Narrow("src") == nullptr);
+    CHECK(Survivors(swapped, "src", cache.Narrow("src")) == expected);
+}
+
+int main() {
+    TestScoring();
+    TestTopMatches();
+    TestMatchIndex();
+    TestCandidateCache();
+    return CheckResult();
+}
@@ -0,0 +1,151 @@
+// Windows argument quoting against the parsing rules of the MSVC runtime,
+// environment overrides, and a real spawn through /bin/sh that reports its
+// argv and environment back and must be reaped afterwards.
+
+#include "check.hpp"
+
+#include "spawn.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+// The command line splitting of CommandLineToArgvW and the MSVC runtime:
+// 2n backslashes before a quote are n backslashes and the quote toggles
+// quoting, 2n+1 are n backslashes and a literal quote, and backslashes
+// anywhere else are literal.
+static std::vector<std::string> ParseWindowsArguments(const std::string& commandLine) {
+    std::vector<std::string> arguments;
+    size_t i = 0;
+    while (i < commandLine.size()) {
+        while (i < commandLine.size() && (commandLine[i] == ' ' || commandLine[i] == '\t')) ++i;
+        if (i == commandLine.size()) break;
+        std::string argument;
+        bool isQuoted = false;
+        while (i < commandLine.size() && (isQuoted || (commandLine[i] != ' ' && commandLine[i] != '\t'))) {
+            size_t backslashes = 0;
+            while (i < commandLine.size() && commandLine[i] == '\\') {
+                ++backslashes;
+                ++i;
+            }
+            if (i < commandLine.size() && commandLine[i] == '"') {
+                argument.append(backslashes / 2, '\\');
+                if (backslashes % 2) argument += '"';
+                else isQuoted = !isQuoted;
+                ++i;
+            } else {
+                argument.append(backslashes, '\\');
+                if (i < commandLine.size() && (isQuoted || (commandLine[i] != ' ' && commandLine[i] != '\t'))) {
+                    argument += commandLine[i++];
+                }
+            }
+        }
+        arguments.push_back(argument);
+    }
+    return arguments;
+}
+
+static void TestQuoting() {
+    CHECK(QuoteWindowsArgument("plain") == "plain");
+    CHECK(QuoteWindowsArgument("") == "\"\"");
+    CHECK(QuoteWindowsArgument("C:\\My Projects\\app") == "\"C:\\My Projects\\app\"");
+    CHECK(QuoteWindowsArgument("say \"hi\"") == "\"say \\\"hi\\\"\"");
+    CHECK(QuoteWindowsArgument("a\\\\\"b") == "\"a\\\\\\\\\\\"b\"");
+    CHECK(QuoteWindowsArgument("C:\\dir\\") == "C:\\dir\\");
+    CHECK(QuoteWindowsArgument("C:\\my dir\\") == "\"C:\\my dir\\\\\"");
+    CHECK(QuoteWindowsArgument("C:\\my dir\\\\") == "\"C:\\my dir\\\\\\\\\"");
+
+    std::vector<std::string> arguments { "", "plain", "two words", "tab\there", "quote\"inside", "\"", "\\",
+                                         "a\\\\\"b", "ends with\\", "ends with\\\\", "\\\\server\\share\\",
+                                         "--folder-uri=vscode-remote://wsl+Ubuntu/home/me/my project" };
+    CHECK(ParseWindowsArguments(JoinWindowsArguments(arguments)) == arguments);
+
+    SpawnRequest request;
+    request.executable = "C:\\Program Files\\Microsoft VS Code\\Code.exe";
+    request.arguments = { "--new-window", "C:\\Users\\me\\My Code\\" };
+    std::vector<std::string> expected { request.executable, "--new-window", "C:\\Users\\me\\My Code\\" };
+    CHECK(ParseWindowsArguments(BuildWindowsCommandLine(request)) == expected);
+}
+
+static void TestEnvironment() {
+    std::vector<std::string> current { "Path=C:\\Windows", "HOME=C:\\Users\\me", "=C:=C:\\work", "KEEP=1" };
+
+    std::vector<std::string> merged = MergeEnvironment(current, { { "PATH", "C:\\bin" }, { "home", "" } }, true);
+    CHECK((merged == std::vector<std::string> { "=C:=C:\\work", "KEEP=1", "PATH=C:\\bin" }));
+
+    merged = MergeEnvironment(current, { { "PATH", "C:\\bin" }, { "home", "" } }, false);
+    CHECK((merged == std::vector<std::string> { "Path=C:\\Windows", "HOME=C:\\Users\\me", "=C:=C:\\work", "KEEP=1",
+                                                "PATH=C:\\bin" }));
+
+    merged = MergeEnvironment(current, { { "MISSING", "" }, { "NEW", "x=y" } }, true);
+    CHECK((merged == std::vector<std::string> { "Path=C:\\Windows", "HOME=C:\\Users\\me", "=C:=C:\\work", "KEEP=1",
+                                                "NEW=x=y" }));
+}
+
+static void TestSpawn() {
+    char directory[] = "/tmp/kinesis-spawn-XXXXXX";
+    CHECK(mkdtemp(directory) != nullptr);
+    std::string output = std::string(directory) + "/out";
+    setenv("KINESIS_SPAWN_REMOVED", "present", 1);
+    setenv("KINESIS_SPAWN_KEPT", "kept", 1);
+
+    // The script writes to a temporary file and renames it, so the file
+    // only appears once it is complete.
+    SpawnRequest request;
+    request.executable = "/bin/sh";
+    request.arguments = { "-c",
+                          "{ for a in \"$0\" \"$@\"; do printf '[%s]\\n' \"$a\"; done;"
+                          "  printf 'set=%s removed=%s kept=%s\\n' \"$KINESIS_SPAWN_SET\" "
+                          "\"${KINESIS_SPAWN_REMOVED-unset}\" \"$KINESIS_SPAWN_KEPT\"; } > \"$OUT.tmp\" && "
+                          "mv \"$OUT.tmp\" \"$OUT\"",
+                          "zero", "two words", "", "quote\"d", "back\\slash" };
+    request.environment = { { "KINESIS_SPAWN_SET", "a b=c" }, { "KINESIS_SPAWN_REMOVED", "" }, { "OUT", output } };
+
+    std::unique_ptr<ProcessSpawner> spawner = CreateProcessSpawner();
+    uint32_t pid = spawner->Spawn(request);
+    CHECK(pid != 0);
+
+    std::string text;
+    for (int attempt = 0; attempt < 500 && text.empty(); ++attempt) {
+        std::ifstream in(output);
+        if (in) {
+            std::stringstream buffer;
+            buffer << in.rdbuf();
+            text = buffer.str();
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    CHECK(text == "[zero]\n[two words]\n[]\n[quote\"d]\n[back\\slash]\nset=a b=c removed=unset kept=kept\n");
+
+    // Once the child has exited the spawner's waiter reaps it, and a
+    // reaped pid no longer exists, where a zombie still would.
+    bool isReaped = false;
+    for (int attempt = 0; attempt < 500 && !isReaped; ++attempt) {
+        isReaped = pid != 0 && kill((pid_t)pid, 0) != 0 && errno == ESRCH;
+        if (!isReaped) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(isReaped);
+
+    request.executable = "/nonexistent/kinesis-editor";
+    request.arguments.clear();
+    CHECK(spawner->Spawn(request) == 0);
+
+    std::remove(output.c_str());
+    rmdir(directory);
+}
+
+int main() {
+    TestQuoting();
+    TestEnvironment();
+    TestSpawn();
+    return CheckResult();
+}
@@ -0,0 +1,80 @@
+// FindSubstring against std::string_view::find, and the CharMask
+// prefilter's promise never to reject a path that matches. The selected
+// kernel hands texts shorter than its block width down to the narrower
+// kernels, so lengths around 16 and 32 exercise every kernel the CPU has.
+
+#include "check.hpp"
+
+#include "matcher.hpp"
+#include "substring.hpp"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+
+static std::string RandomText(std::mt19937& rng, size_t length, const char* alphabet, size_t alphabetSize) {
+    std::string text(length, ' ');
+    for (auto& c : text) c = alphabet[rng() % alphabetSize];
+    return text;
+}
+
+static void TestFindSubstring() {
+    std::printf("kernel: %s\n", SubstringKernelName());
+
+    // A tiny alphabet makes first/last-byte hits common, so the
+    // verification step and the masked overlapping tail block both run.
+    std::mt19937 rng(1);
+    size_t mismatches = 0;
+    for (int i = 0; i < 200000; ++i) {
+        std::string text = RandomText(rng, rng() % 100, "ab\\c", 4);
+        std::string pattern = RandomText(rng, 1 + rng() % 6, "ab\\c", 4);
+        size_t from = rng() % (text.size() + 2);
+        if (FindSubstring(text, pattern, from) != std::string_view(text).find(pattern, from)) ++mismatches;
+    }
+    CHECK(mismatches == 0);
+
+    for (size_t length = 2; length <= 70; ++length) {
+        std::string text(length, 'a');
+        text[length - 1] = 'z';
+        CHECK(FindSubstring(text, "az") == length - 2);
+        CHECK(FindSubstring(text, "za") == std::string_view::npos);
+        CHECK(FindSubstring(text, text) == 0);
+        CHECK(FindSubstring(text, text + "a") == std::string_view::npos);
+    }
+
+    std::string path = "c:\\users\\me\\onedrive - company\\documents\\kinesis\\src";
+    CHECK(FindSubstring(path, "") == 0);
+    CHECK(FindSubstring(path, "", path.size()) == path.size());
+    CHECK(FindSubstring(path, "src", path.size() + 1) == std::string_view::npos);
+    CHECK(FindSubstring(path, "kinesis") == path.find("kinesis"));
+    CHECK(FindSubstring(path, "kinesis", path.find("kinesis") + 1) == std::string_view::npos);
+    CHECK(FindSubstring(path, "\\s") == path.find("\\s"));
+}
+
+static void TestCharMask() {
+    CHECK(CouldMatch(CharMask("kin"), CharMask("c:\\work\\kinesis")));
+    CHECK(!CouldMatch(CharMask("kinz"), CharMask("c:\\work\\kinesis")));
+    CHECK(!CouldMatch(CharMask("2023"), CharMask("c:\\photos2022")));
+    CHECK(CouldMatch(CharMask(""), CharMask("")));
+
+    // Any subsequence of a text passes the text's mask, for every byte value.
+    std::mt19937 rng(5);
+    size_t rejected = 0;
+    for (int i = 0; i < 100000; ++i) {
+        std::string text(1 + rng() % 60, ' ');
+        for (auto& c : text) c = (char)(rng() % 256);
+        std::string pattern;
+        for (char c : text) {
+            if (rng() % 4 == 0) pattern += c;
+        }
+        if (!CouldMatch(CharMask(pattern), CharMask(text))) ++rejected;
+    }
+    CHECK(rejected == 0);
+}
+
+int main() {
+    TestFindSubstring();
+    TestCharMask();
+    return CheckResult();
+}
@@ -0,0 +1,64 @@
+// Trigram candidates against a linear substring scan: the candidates may
+// hold extra paths, but never miss one that contains the pattern.
+
+#include "check.hpp"
+#include "synthetic.hpp"
+
+#include "folderindex.hpp"
+#include "matcher.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::vector<uint32_t> LinearScan(const std::vector<std::string>& lowerPaths, const std::string& pattern) {
+    std::vector<uint32_t> ids;
+    for (size_t i = 0; i < lowerPaths.size(); ++i) {
+        if (lowerPaths[i].find(pattern) != std::string::npos) ids.push_back((uint32_t)i);
+    }
+    return ids;
+}
+
+static void CheckPattern(const FolderIndex& index, const std::vector<std::string>& lowerPaths, const std::string& pattern) {
+    std::vector<uint32_t> candidates;
+    CHECK(index.TrigramCandidates(pattern, candidates));
+    CHECK(std::is_sorted(candidates.begin(), candidates.end()));
+    CHECK(std::adjacent_find(candidates.begin(), candidates.end()) == candidates.end());
+
+    std::vector<uint32_t> verified;
+    for (uint32_t id : candidates) {
+        if (lowerPaths[id].find(pattern) != std::string::npos) verified.push_back(id);
+    }
+    if (verified != LinearScan(lowerPaths, pattern)) {
+        std::fprintf(stderr, "pattern \"%s\" disagrees with the linear scan\n", pattern.c_str());
+        CHECK(!"trigram candidates miss a path");
+    }
+}
+
+int main() {
+    std::vector<std::string> paths = SyntheticPaths(100000, 3);
+    std::sort(paths.begin(), paths.end());
+    FolderIndex index;
+    index.Build(paths);
+    std::vector<std::string> lowerPaths;
+    for (const auto& path : paths) lowerPaths.push_back(LowerPattern(path));
+
+    std::vector<uint32_t> candidates;
+    CHECK(!index.TrigramCandidates("ab", candidates));
+    CHECK(index.TrigramCandidates("qqq", candidates) && candidates.empty());
+
+    for (std::string pattern : { "src", "kinesis", "photos2023", "\\\\wsl", "widget\\core", "a\\b" }) {
+        CheckPattern(index, lowerPaths, pattern);
+    }
+
+    // Substrings cut at random from the indexed paths, so most of them hit.
+    std::mt19937 rng(11);
+    for (int i = 0; i < 300; ++i) {
+        const std::string& path = lowerPaths[rng() % lowerPaths.size()];
+        size_t length = 3 + rng() % 10;
+        if (path.size() < length) continue;
+        CheckPattern(index, lowerPaths, path.substr(rng() % (path.size() - length + 1), length));
+    }
+    return CheckResult();
+}
@@ -0,0 +1,56 @@
+// Roots the watcher cannot follow are reported instead of silently
+// dropped, and a folder moved in from outside arrives as one Added event.
+
+#include "check.hpp"
+
+#include "watcher.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+int main() {
+    char directory[] = "/tmp/kinesis-watch-XXXXXX";
+    CHECK(mkdtemp(directory) != nullptr);
+    std::string root = std::string(directory) + "/root";
+    std::string outside = std::string(directory) + "/outside";
+    std::string missing = std::string(directory) + "/missing";
+    std::filesystem::create_directories(root);
+    std::filesystem::create_directories(outside + "/moved/nested");
+
+    std::mutex mutex;
+    std::condition_variable arrived;
+    std::vector<FolderEvent> received;
+    ExcludeRules excludes;
+    std::unique_ptr<DirectoryWatcher> watcher = CreateDirectoryWatcher();
+    watcher->settleMs = 20;
+    watcher->maxDelayMs = 100;
+    CHECK(watcher->Start({ root, missing }, excludes, [&](const std::vector<FolderEvent>& events) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.insert(received.end(), events.begin(), events.end());
+        arrived.notify_one();
+    }));
+    CHECK(watcher->UnwatchedRoots() == std::vector<std::string> { missing });
+
+    std::filesystem::rename(outside + "/moved", root + "/moved");
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        arrived.wait_for(lock, std::chrono::seconds(5), [&] { return !received.empty(); });
+        CHECK(received.size() == 1);
+        if (!received.empty()) {
+            CHECK(received[0].change == FolderChange::Added);
+            CHECK(received[0].path == root + "/moved");
+        }
+    }
+    watcher->Stop();
+
+    CHECK(!watcher->Start({ missing }, excludes, [](const std::vector<FolderEvent>&) {}));
+    CHECK(watcher->UnwatchedRoots() == std::vector<std::string> { missing });
+
+    std::filesystem::remove_all(directory);
+    return CheckResult();
+}